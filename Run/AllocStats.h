@@ -0,0 +1,183 @@
+#pragma once
+
+// Heap allocation counting through a replaced global operator new.
+//
+// The counters are per thread so the numbers for the engine thread are not
+// polluted by any worker threads.  The replacement operators are only
+// compiled into the translation unit that defines
+// RUN_ALLOC_STATS_IMPLEMENTATION before including this header; without it
+// every counter stays at zero.  RUN_ALLOC_STATS is defined whenever the
+// counters are live so callers can tell the difference.
+//
+// NextFrame() closes the current frame and files its allocations under a
+// tag (the game uses the GameState), so the totals per frame and per tag can
+// be read back for a debug overlay or a budget check.
+
+#if defined(RUN_ALLOC_STATS_IMPLEMENTATION) && !defined(RUN_ALLOC_STATS)
+#define RUN_ALLOC_STATS
+#endif
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace alloc_stats {
+	struct Counters {
+		uint64_t count = 0;
+		uint64_t bytes = 0;
+
+		Counters operator-(const Counters& other) const {
+			return { count - other.count, bytes - other.bytes };
+		}
+	};
+
+	inline thread_local Counters thread_counters;
+
+	// Totals for the calling thread since it started
+	inline Counters Snapshot() {
+		return thread_counters;
+	}
+
+	constexpr int max_tags = 32;
+
+	struct TagStats {
+		uint64_t frames = 0;
+		Counters total;
+		Counters peak; // the worst single frame
+	};
+
+	inline thread_local Counters frame_start;
+	inline thread_local Counters last_frame;
+	inline thread_local int frame_tag = -1;
+	inline thread_local std::array<TagStats, max_tags> tag_stats;
+
+	// Ends the frame in progress, filing it under the tag it was started
+	// with, and starts a new one under tag
+	inline void NextFrame(int tag) {
+		Counters now = thread_counters;
+		last_frame = now - frame_start;
+		frame_start = now;
+
+		if (frame_tag >= 0 && frame_tag < max_tags) {
+			TagStats& s = tag_stats[frame_tag];
+			s.frames++;
+			s.total.count += last_frame.count;
+			s.total.bytes += last_frame.bytes;
+			s.peak.count = last_frame.count > s.peak.count ? last_frame.count : s.peak.count;
+			s.peak.bytes = last_frame.bytes > s.peak.bytes ? last_frame.bytes : s.peak.bytes;
+		}
+		frame_tag = tag;
+	}
+
+	// Allocations made by the calling thread during the last completed frame
+	inline Counters LastFrame() {
+		return last_frame;
+	}
+
+	inline const TagStats& StatsFor(int tag) {
+		static const TagStats none;
+		return tag >= 0 && tag < max_tags ? tag_stats[tag] : none;
+	}
+
+	inline void Reset() {
+		tag_stats = {};
+		frame_start = thread_counters;
+		last_frame = {};
+		frame_tag = -1;
+	}
+}
+
+#if defined(RUN_ALLOC_STATS_IMPLEMENTATION)
+#undef RUN_ALLOC_STATS_IMPLEMENTATION
+
+#include <cstdlib>
+#include <new>
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+// Kept out of line so the compiler does not inline free() into delete
+// expressions and then warn that it frees memory from operator new
+#if defined(_MSC_VER)
+#define RUN_ALLOC_NOINLINE __declspec(noinline)
+#else
+#define RUN_ALLOC_NOINLINE __attribute__((noinline))
+#endif
+
+namespace alloc_stats {
+	// Over-aligned blocks, such as SIMD buffers, need the platform's aligned
+	// allocator and its matching free
+	inline void* AlignedMalloc(std::size_t size, std::size_t align) {
+		size = size ? size : 1;
+#if defined(_WIN32)
+		return _aligned_malloc(size, align);
+#else
+		void* p = nullptr;
+		return posix_memalign(&p, align < sizeof(void*) ? sizeof(void*) : align, size) == 0 ? p : nullptr;
+#endif
+	}
+
+	inline void AlignedFree(void* p) {
+#if defined(_WIN32)
+		_aligned_free(p);
+#else
+		std::free(p);
+#endif
+	}
+}
+
+RUN_ALLOC_NOINLINE void* operator new(std::size_t size) {
+	alloc_stats::thread_counters.count++;
+	alloc_stats::thread_counters.bytes += size;
+	if (void* p = std::malloc(size ? size : 1)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+RUN_ALLOC_NOINLINE void* operator new[](std::size_t size) {
+	return ::operator new(size);
+}
+
+RUN_ALLOC_NOINLINE void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	alloc_stats::thread_counters.count++;
+	alloc_stats::thread_counters.bytes += size;
+	return std::malloc(size ? size : 1);
+}
+
+RUN_ALLOC_NOINLINE void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+	return ::operator new(size, tag);
+}
+
+RUN_ALLOC_NOINLINE void* operator new(std::size_t size, std::align_val_t align) {
+	alloc_stats::thread_counters.count++;
+	alloc_stats::thread_counters.bytes += size;
+	if (void* p = alloc_stats::AlignedMalloc(size, std::size_t(align))) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+RUN_ALLOC_NOINLINE void* operator new[](std::size_t size, std::align_val_t align) {
+	return ::operator new(size, align);
+}
+
+RUN_ALLOC_NOINLINE void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+	alloc_stats::thread_counters.count++;
+	alloc_stats::thread_counters.bytes += size;
+	return alloc_stats::AlignedMalloc(size, std::size_t(align));
+}
+
+RUN_ALLOC_NOINLINE void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t& tag) noexcept {
+	return ::operator new(size, align, tag);
+}
+
+RUN_ALLOC_NOINLINE void operator delete(void* p) noexcept { std::free(p); }
+RUN_ALLOC_NOINLINE void operator delete[](void* p) noexcept { std::free(p); }
+RUN_ALLOC_NOINLINE void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+RUN_ALLOC_NOINLINE void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+RUN_ALLOC_NOINLINE void operator delete(void* p, std::align_val_t) noexcept { alloc_stats::AlignedFree(p); }
+RUN_ALLOC_NOINLINE void operator delete[](void* p, std::align_val_t) noexcept { alloc_stats::AlignedFree(p); }
+RUN_ALLOC_NOINLINE void operator delete(void* p, std::size_t, std::align_val_t) noexcept { alloc_stats::AlignedFree(p); }
+RUN_ALLOC_NOINLINE void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { alloc_stats::AlignedFree(p); }
+#endif
@@ -0,0 +1,207 @@
+#pragma once
+
+// Loads sprites and decals without stalling the frame.
+//
+// Images are decoded on a pool of worker threads through the engine's image
+// loader (ImageLoader_LibPNG, ImageLoader_STB, ...).  Decals need the
+// renderer, so their textures are created on the engine thread: the loader
+// hooks the engine as a PGEX and uploads finished decodes before each
+// OnUserUpdate, stopping once the frame's upload budget is spent.  Loads
+// return a handle the game polls, for example from EnterState.
+//
+//	olc::AsyncLoader loader;                   // after the engine is constructed
+//	auto back = loader.LoadDecal("cards/back.png");
+//	...
+//	if (back.Ready()) pge->DrawDecal(pos, back.Decal());
+//
+// Images in an olc::ResourcePack are decoded one at a time, the pack shares
+// a single file stream.  Anything else, such as a view into an
+// olc::MappedPack, can be decoded by passing a function to Load.
+
+#include "olcPixelGameEngine.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace olc
+{
+	class AsyncLoader : public olc::PGEX
+	{
+	public:
+		enum class State { QUEUED, DECODED, READY, FAILED };
+
+		struct Asset
+		{
+			std::atomic<State> state{ State::QUEUED };
+			std::function<olc::rcode(olc::Sprite&)> decode;
+			bool bDecal = false;
+			bool bFilter = false;
+			bool bClamp = true;
+			std::unique_ptr<olc::Sprite> pSprite;
+			std::unique_ptr<olc::Decal> pDecal;
+		};
+
+		// Shared ownership of one load.  The sprite and decal live as long as
+		// any handle to them does.
+		class Handle
+		{
+		public:
+			Handle() = default;
+			explicit Handle(std::shared_ptr<Asset> asset) : pAsset(std::move(asset)) {}
+
+			bool Ready() const { return pAsset && pAsset->state.load(std::memory_order_acquire) == State::READY; }
+			bool Failed() const { return !pAsset || pAsset->state.load(std::memory_order_acquire) == State::FAILED; }
+			bool Done() const { return Ready() || Failed(); }
+
+			// Null until Ready
+			olc::Sprite* Sprite() const { return Ready() ? pAsset->pSprite.get() : nullptr; }
+			olc::Decal* Decal() const { return Ready() ? pAsset->pDecal.get() : nullptr; }
+
+		private:
+			std::shared_ptr<Asset> pAsset;
+		};
+
+		// nThreads 0 uses one less than the hardware threads, leaving one for the
+		// engine.  Up to fUploadBudgetMs of each frame goes to creating textures,
+		// always at least one.
+		explicit AsyncLoader(int nThreads = 0, float fUploadBudgetMs = 2.0f)
+			: olc::PGEX(true), fUploadBudget(fUploadBudgetMs)
+		{
+			if (nThreads <= 0) nThreads = std::max(1, int(std::thread::hardware_concurrency()) - 1);
+			for (int i = 0; i < nThreads; i++) vWorkers.emplace_back(&AsyncLoader::Work, this);
+		}
+
+		// Loads not finished yet are dropped, their handles report Failed
+		~AsyncLoader()
+		{
+			{
+				std::lock_guard<std::mutex> lock(muxJobs);
+				bQuit = true;
+				for (auto& job : qJobs) job->state = State::FAILED;
+				qJobs.clear();
+			}
+			cvJobs.notify_all();
+			for (auto& t : vWorkers) t.join();
+			for (auto& upload : qUploads) upload->state = State::FAILED;
+		}
+
+		Handle LoadSprite(const std::string& sImageFile, olc::ResourcePack* pack = nullptr)
+		{
+			return Load(FromFile(sImageFile, pack), false);
+		}
+
+		Handle LoadDecal(const std::string& sImageFile, olc::ResourcePack* pack = nullptr, bool filter = false, bool clamp = true)
+		{
+			return Load(FromFile(sImageFile, pack), true, filter, clamp);
+		}
+
+		// decode fills in the sprite on a worker thread
+		Handle Load(std::function<olc::rcode(olc::Sprite&)> decode, bool bDecal, bool filter = false, bool clamp = true)
+		{
+			auto asset = std::make_shared<Asset>();
+			asset->decode = std::move(decode);
+			asset->bDecal = bDecal;
+			asset->bFilter = filter;
+			asset->bClamp = clamp;
+			{
+				std::lock_guard<std::mutex> lock(muxJobs);
+				qJobs.push_back(asset);
+				nPending++;
+			}
+			cvJobs.notify_one();
+			return Handle(asset);
+		}
+
+		// Loads not yet Ready or Failed
+		int Pending() const { return nPending.load(); }
+
+	protected:
+		bool OnBeforeUserUpdate(float& fElapsedTime) override
+		{
+			auto start = std::chrono::steady_clock::now();
+			while (true)
+			{
+				std::shared_ptr<Asset> asset;
+				{
+					std::lock_guard<std::mutex> lock(muxUploads);
+					if (qUploads.empty()) break;
+					asset = std::move(qUploads.front());
+					qUploads.pop_front();
+				}
+
+				asset->pDecal = std::make_unique<olc::Decal>(asset->pSprite.get(), asset->bFilter, asset->bClamp);
+				asset->state.store(State::READY, std::memory_order_release);
+				nPending--;
+
+				std::chrono::duration<float, std::milli> spent = std::chrono::steady_clock::now() - start;
+				if (spent.count() >= fUploadBudget) break;
+			}
+			return false;
+		}
+
+	private:
+		float fUploadBudget;
+		std::vector<std::thread> vWorkers;
+		std::mutex muxJobs;
+		std::condition_variable cvJobs;
+		std::deque<std::shared_ptr<Asset>> qJobs;
+		bool bQuit = false;
+		std::mutex muxUploads;
+		std::deque<std::shared_ptr<Asset>> qUploads;
+		std::atomic<int> nPending{ 0 };
+		std::mutex muxPack;
+
+		std::function<olc::rcode(olc::Sprite&)> FromFile(const std::string& sImageFile, olc::ResourcePack* pack)
+		{
+			return [this, sImageFile, pack](olc::Sprite& spr)
+			{
+				// Headless builds have no image loader
+				if (olc::Sprite::loader == nullptr) return olc::rcode::FAIL;
+				if (pack == nullptr) return spr.LoadFromFile(sImageFile);
+				std::lock_guard<std::mutex> lock(muxPack);
+				return spr.LoadFromFile(sImageFile, pack);
+			};
+		}
+
+		void Work()
+		{
+			while (true)
+			{
+				std::shared_ptr<Asset> asset;
+				{
+					std::unique_lock<std::mutex> lock(muxJobs);
+					cvJobs.wait(lock, [this] { return bQuit || !qJobs.empty(); });
+					if (bQuit) return;
+					asset = std::move(qJobs.front());
+					qJobs.pop_front();
+				}
+
+				asset->pSprite = std::make_unique<olc::Sprite>();
+				if (asset->decode(*asset->pSprite) != olc::rcode::OK)
+				{
+					asset->pSprite.reset();
+					asset->state.store(State::FAILED, std::memory_order_release);
+					nPending--;
+				}
+				else if (asset->bDecal)
+				{
+					asset->state.store(State::DECODED, std::memory_order_release);
+					std::lock_guard<std::mutex> lock(muxUploads);
+					qUploads.push_back(std::move(asset));
+				}
+				else
+				{
+					asset->state.store(State::READY, std::memory_order_release);
+					nPending--;
+				}
+			}
+		}
+	};
+}
@@ -0,0 +1,665 @@
+// Microbenchmarks for the game core.
+//
+// Reports ns/op and heap allocations/op for the hot paths in Game.h and can
+// save the results as a JSON baseline, or compare against one and fail when
+// something regressed.
+//
+// Build (from the repository root):
+//	g++ -std=c++17 -O2 Run/Bench.cpp -o bench -lpthread
+//	cl /std:c++17 /O2 /EHsc Run\Bench.cpp
+//
+// Usage:
+//	bench [--filter text] [--save file] [--baseline file] [--threshold percent]
+
+#define OLC_PGE_HEADLESS
+#define OLC_PGE_APPLICATION
+#include "olcPixelGameEngine.h"
+#define OLC_PGEX_TRANSFORMEDVIEW
+#include "olcPGEX_TransformedView.h"
+
+#define RUN_ALLOC_STATS_IMPLEMENTATION
+#include "AllocStats.h"
+#include "Game.h"
+#include "HitGrid.h"
+#include "Planner.h"
+#include "ScoreBatch.h"
+#include "Search.h"
+#include "Tween.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+// Results are folded into this so the optimizer cannot drop the work
+volatile int64_t sink = 0;
+
+struct BenchResult {
+	std::string name;
+	double ns_per_op = 0.0;
+	double allocs_per_op = 0.0;
+	double bytes_per_op = 0.0;
+};
+
+std::vector<BenchResult> results;
+std::string filter;
+
+// Checks that failed, reported by a nonzero exit code
+int failures = 0;
+
+// Times op in batches of at least 20ms and keeps the fastest batch
+template <typename F>
+void Measure(const std::string& name, F&& op) {
+	if (!filter.empty() && name.find(filter) == std::string::npos) {
+		return;
+	}
+
+	using clock = std::chrono::steady_clock;
+	const auto min_batch = std::chrono::milliseconds(20);
+
+	// Warm up and find an iteration count that fills a batch
+	uint64_t iterations = 1;
+	while (true) {
+		auto start = clock::now();
+		for (uint64_t i = 0; i < iterations; i++) {
+			op();
+		}
+		if (clock::now() - start >= min_batch || iterations >= (1ull << 30)) {
+			break;
+		}
+		iterations *= 2;
+	}
+
+	double best_ns = 1e300;
+	alloc_stats::Counters allocs;
+	const int batches = 5;
+
+	for (int b = 0; b < batches; b++) {
+		auto before = alloc_stats::Snapshot();
+		auto start = clock::now();
+		for (uint64_t i = 0; i < iterations; i++) {
+			op();
+		}
+		auto end = clock::now();
+		auto used = alloc_stats::Snapshot() - before;
+		allocs.count += used.count;
+		allocs.bytes += used.bytes;
+
+		double ns = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+		best_ns = std::min(best_ns, ns);
+	}
+
+	BenchResult r;
+	r.name = name;
+	r.ns_per_op = best_ns;
+	r.allocs_per_op = double(allocs.count) / (iterations * batches);
+	r.bytes_per_op = double(allocs.bytes) / (iterations * batches);
+	results.push_back(r);
+
+	std::printf("%-56s %12.1f ns/op %10.2f allocs/op %10.1f B/op\n", r.name.c_str(), r.ns_per_op, r.allocs_per_op, r.bytes_per_op);
+}
+
+// A bare engine instance so the decal paths have fonts and a layer to draw into
+class BenchEngine : public olc::PixelGameEngine {
+public:
+	bool OnUserCreate() override { return true; }
+	bool OnUserUpdate(float fElapsedTime) override { return true; }
+
+	// Equivalent of the end of a frame, decals are consumed by the renderer
+	void FlushDecals() {
+		for (auto& layer : GetLayers()) {
+			olc_RecycleDecalInstances(layer);
+		}
+	}
+};
+
+void BenchDeck() {
+	for (int length : { 5, 6, 7, 9 }) {
+		Measure("CreateDeck/" + std::to_string(length), [=] {
+			sink += CreateDeck(length, length, length).size();
+		});
+	}
+
+	for (int length : { 5, 6, 7, 9 }) {
+		auto deck = CreateDeck(length, length, length);
+		Measure("Shuffle/" + std::to_string(deck.size()), [&] {
+			std::shuffle(std::begin(deck), std::end(deck), rng);
+			sink += deck.back().number;
+		});
+	}
+
+	// Returning a run of cards must not depend on how big the deck is
+	for (int length : { 5, 9 }) {
+		Deck deck;
+		deck.cards = CreateDeck(length, length, length);
+		std::vector<Card> run(std::begin(deck.cards), std::begin(deck.cards) + 6);
+		size_t full_size = deck.size();
+		Measure("Deck::Insert/6 into " + std::to_string(full_size), [&] {
+			deck.Insert(std::begin(run), std::end(run), rng);
+			deck.cards.resize(full_size);
+			sink += deck.cards.back().number;
+		});
+	}
+}
+
+void BenchIsValid() {
+	// Only these rules change how IsValid compares cards
+	const std::array<const char*, 4> rule_names = { "run_backwards", "double_jump", "carbon_copy", "monochrome" };
+
+	auto deck = CreateDeck(9, 9, 9);
+	std::shuffle(std::begin(deck), std::end(deck), std::mt19937(12345));
+
+	for (int combo = 0; combo < (1 << rule_names.size()); combo++) {
+		enabled_rules.clear();
+		std::string name = "IsValid/";
+		for (size_t r = 0; r < rule_names.size(); r++) {
+			if (combo & (1 << r)) {
+				enabled_rules[rule_names[r]] = possible_rules.at(rule_names[r]);
+				name += (name.back() == '/' ? "" : "+") + std::string(rule_names[r]);
+			}
+		}
+		if (combo == 0) {
+			name += "none";
+		}
+
+		size_t i = 0;
+		Measure(name, [&] {
+			sink += IsValid(deck[i], deck[i + 1]);
+			i = (i + 1) % (deck.size() - 1);
+		});
+	}
+	enabled_rules.clear();
+}
+
+void BenchScore() {
+	auto deck = CreateDeck(9, 9, 9);
+	std::shuffle(std::begin(deck), std::end(deck), std::mt19937(12345));
+
+	for (int length = 3; length <= 20; length++) {
+		std::vector<Card> run(std::begin(deck), std::begin(deck) + length);
+		Measure("Score/" + std::to_string(length), [&] {
+			sink += Score(run);
+		});
+	}
+
+	// Many candidate runs at once, checked against scoring them one at a time
+	std::mt19937 pick(12345);
+	std::vector<std::vector<sim::Card>> runs(1024);
+	sim::RunBatch batch;
+	for (auto& run : runs) {
+		int length = 1 + int(pick() % 20);
+		for (int i = 0; i < length; i++) {
+			run.push_back(sim::MakeCard(int(pick() % 729), 9));
+		}
+		batch.Add(run.data(), run.size());
+	}
+	batch.Add(nullptr, 0);
+	runs.emplace_back();
+
+	std::vector<int> scores(batch.Runs());
+	for (uint32_t rules : { 0u, 0xFFFu, 0x155u, 0xAAAu }) {
+		sim::ScoreBatch(batch, rules, scores.data());
+		for (size_t r = 0; r < runs.size(); r++) {
+			if (scores[r] != sim::Score(runs[r].data(), runs[r].size(), rules)) {
+				std::printf("sim::ScoreBatch disagrees with sim::Score on run %zu with rules %x\n", r, rules);
+				failures++;
+				break;
+			}
+		}
+	}
+
+	Measure("sim::Score/1024 runs", [&] {
+		for (auto& run : runs) {
+			sink += sim::Score(run.data(), run.size(), 0);
+		}
+	});
+	Measure("sim::ScoreBatch/1024 runs", [&] {
+		sim::ScoreBatch(batch, 0, scores.data());
+		sink += scores[0];
+	});
+}
+
+void BenchLayout() {
+	auto deck = CreateDeck(5, 5, 5);
+
+	Hand h;
+	Measure("Hand::Add/7", [&] {
+		h.cards.clear();
+		for (int i = 0; i < 7; i++) {
+			h.Add(deck[i]);
+		}
+		sink += h.cards.size();
+	});
+
+	InPlay p;
+	Measure("InPlay::Add/12", [&] {
+		p.cards.clear();
+		for (int i = 0; i < 12; i++) {
+			p.Add(deck[i]);
+		}
+		sink += p.cards.size();
+	});
+
+	// A dense board of cards in rows, as a large hand mode would lay out
+	std::vector<olc::vf2d> board;
+	for (float y = 0.0f; y + card_size.y <= 240.0f; y += card_size.y + 1.0f) {
+		for (float x = 0.0f; x + card_size.x <= 256.0f; x += card_size.x / 2.0f) {
+			board.push_back({ x, y });
+		}
+	}
+	std::string count = std::to_string(board.size());
+	std::vector<olc::vf2d> clicks;
+	std::mt19937 click_rng(12345);
+	for (int i = 0; i < 1024; i++) {
+		clicks.push_back({ std::uniform_real_distribution<float>(0.0f, 256.0f)(click_rng), std::uniform_real_distribution<float>(0.0f, 240.0f)(click_rng) });
+	}
+
+	HitGrid grid;
+	auto build = [&] {
+		grid.Clear();
+		for (int i = 0; i < int(board.size()); i++) {
+			grid.Add(i, board[i], card_size);
+		}
+		sink += grid.At(clicks[0]);
+	};
+	Measure("HitGrid::Add+Build/" + count, build);
+	build();
+
+	// The linear scan it replaces, topmost card first
+	auto scan = [&](const olc::vf2d& point) {
+		for (int i = int(board.size()) - 1; i >= 0; i--) {
+			if (PointInRect(point, board[i], card_size)) {
+				return i;
+			}
+		}
+		return -1;
+	};
+	int mismatches = 0;
+	for (const auto& point : clicks) {
+		mismatches += scan(point) != grid.At(point);
+	}
+	if (mismatches > 0) {
+		std::printf("HitGrid disagrees with the linear scan on %d clicks\n", mismatches);
+		failures++;
+	}
+
+	size_t click = 0;
+	Measure("PointInRect scan/" + count, [&] {
+		sink += scan(clicks[click++ & 1023]);
+	});
+	Measure("HitGrid::At/" + count, [&] {
+		sink += grid.At(clicks[click++ & 1023]);
+	});
+}
+
+void BenchTween() {
+	// Many cards in flight at once with mixed easings, all sent back the other
+	// way once the last has arrived
+	std::vector<olc::vf2d> positions(64);
+	TweenSet tweens(positions.size());
+	Easing easings[] = { Easing::LINEAR, Easing::IN_OUT, Easing::OUT };
+	float x = 0.0f;
+	Measure("TweenSet::Update/64", [&] {
+		if (!tweens.Active()) {
+			x = 200.0f - x;
+			for (size_t i = 0; i < positions.size(); i++) {
+				tweens.Start(&positions[i], { x, float(i) }, 0.25f + i * 0.01f, easings[i % 3]);
+			}
+		}
+		tweens.Update(1.0f / 60.0f);
+		sink += int(positions[0].x);
+	});
+}
+
+void BenchSim() {
+	// Whole games with a random legal action each step, the training environment's inner loop
+	for (int length : { 5, 9 }) {
+		sim::Game game;
+		game.Reset(12345, length);
+		std::mt19937 policy(12345);
+		uint32_t seed = 0;
+		Measure("sim::Game::Step/" + std::to_string(length), [&] {
+			if (game.over) {
+				game.Reset(++seed, length);
+			}
+			uint32_t mask = game.ActionMask();
+			int action = 0;
+			for (uint32_t pick = policy() % sim::ACTION_COUNT; !(mask & (1u << action)) || pick-- > 0; ) {
+				action = (action + 1) % sim::ACTION_COUNT;
+			}
+			sink += game.Step(action);
+		});
+	}
+
+	// Which of a full hand can follow the last card, per card and all at once
+	std::vector<sim::HandLanes> hands(256);
+	std::vector<sim::Card> last(hands.size());
+	std::mt19937 deal(7);
+	for (size_t h = 0; h < hands.size(); h++) {
+		for (int i = 0; i < sim::hand_limit; i++) {
+			hands[h][i] = sim::MakeCard(int(deal() % 729), 9);
+		}
+		last[h] = sim::MakeCard(int(deal() % 729), 9);
+	}
+	size_t h = 0;
+	Measure("sim::IsValid/hand of 7", [&] {
+		uint32_t rules = uint32_t(h) & 0xFFF;
+		uint32_t mask = 0;
+		for (int i = 0; i < sim::hand_limit; i++) {
+			mask |= sim::IsValid(last[h], hands[h][i], rules) ? 1u << i : 0u;
+		}
+		sink += mask;
+		h = (h + 1) % hands.size();
+	});
+	Measure("sim::PlayableMask/hand of 7", [&] {
+		sink += sim::PlayableMask(last[h], hands[h], sim::hand_limit, uint32_t(h) & 0xFFF);
+		h = (h + 1) % hands.size();
+	});
+}
+
+void BenchSearch() {
+	TranspositionTable table(16 << 20);
+
+	Measure("TranspositionTable::Store+Probe", [&, key = uint64_t(1)]() mutable {
+		key = sim::zobrist::SplitMix(key);
+		table.Store(key, { 1.0f, 1, TranspositionTable::EXACT, 0 });
+		TranspositionTable::Entry e;
+		sink += table.Probe(key, e) ? e.depth : 0;
+	});
+
+	// Opening hands, searched from scratch and then again with the answers cached
+	std::vector<sim::Game> games(16);
+	for (size_t i = 0; i < games.size(); i++) {
+		games[i].Reset(uint32_t(i), 5);
+	}
+
+	// Small enough that clearing it is noise next to the search
+	TranspositionTable cold_table(64 << 10);
+	size_t i = 0;
+	Measure("search::BestRun/cold", [&] {
+		cold_table.Clear();
+		sink += search::BestRun(games[i], cold_table).score;
+		i = (i + 1) % games.size();
+	});
+
+	Measure("search::BestRun/cached", [&] {
+		sink += search::BestRun(games[i], table).score;
+		i = (i + 1) % games.size();
+	});
+
+	// Full depth 2 and 3 searches with no time limit, these should stay under the 50ms a planner gets
+	TranspositionTable plan_table(4 << 20);
+	for (int depth = 2; depth <= 3; depth++) {
+		planner::Options options;
+		options.max_depth = depth;
+		options.budget_ms = 1e6;
+		Measure("planner::Choose/depth" + std::to_string(depth), [&] {
+			plan_table.Clear();
+			sink += planner::Choose(games[i], options, plan_table, 1).action;
+			i = (i + 1) % games.size();
+		});
+	}
+}
+
+void BenchDraw(BenchEngine& engine) {
+	auto deck = CreateDeck(5, 5, 5);
+
+	// Flush every 64 draws, roughly one frame's worth of cards
+	int drawn = 0;
+	Measure("Card::Draw", [&] {
+		deck[drawn].Draw(&engine, 0.3f);
+		if (++drawn == 64) {
+			engine.FlushDecals();
+			drawn = 0;
+		}
+	});
+	engine.FlushDecals();
+
+	drawn = 0;
+	Measure("DrawStringDecal", [&] {
+		engine.DrawStringDecal({ 10.0f, 10.0f }, "Score: 1234");
+		if (++drawn == 64) {
+			engine.FlushDecals();
+			drawn = 0;
+		}
+	});
+	engine.FlushDecals();
+
+	// Runs past the width of the screen are zoomed out and then culled, so
+	// the cost should level off
+	auto long_deck = CreateDeck(9, 9, 9);
+	for (int length : { 8, 24, 200 }) {
+		InPlay row;
+		for (int i = 0; i < length; i++) {
+			row.Add(long_deck[i]);
+		}
+		Measure("InPlay::Draw/" + std::to_string(length), [&] {
+			row.Draw(&engine);
+			engine.FlushDecals();
+		});
+	}
+}
+
+// Bulk pixel operations over a screen's worth of pixels, checked against the
+// per pixel operators
+void BenchPixels(BenchEngine& engine) {
+	std::mt19937 pick(12345);
+	olc::Sprite src(256, 240), dst(256, 240);
+	const size_t count = size_t(src.width) * src.height;
+	for (size_t i = 0; i < count; i++) {
+		src.GetData()[i].n = pick();
+		dst.GetData()[i].n = pick();
+	}
+	const olc::Pixel* a = src.GetData();
+	olc::Pixel* d = dst.GetData();
+
+	std::vector<olc::Pixel> out(count);
+	olc::PixelScale(out.data(), a, count, 0.6f);
+	for (size_t i = 0; i < count; i++) {
+		if (out[i] != a[i] * 0.6f) {
+			std::printf("olc::PixelScale disagrees with Pixel::operator* at %zu\n", i);
+			failures++;
+			break;
+		}
+	}
+	olc::PixelLerp(out.data(), a, d, count, 0.3f);
+	for (size_t i = 0; i < count; i++) {
+		if (out[i] != olc::PixelLerp(a[i], d[i], 0.3f)) {
+			std::printf("olc::PixelLerp disagrees with the single pixel version at %zu\n", i);
+			failures++;
+			break;
+		}
+	}
+
+	// Blending through Draw one pixel at a time is the reference for the blit
+	olc::Sprite drawn(256, 240);
+	std::copy(d, d + count, drawn.GetData());
+	engine.SetPixelMode(olc::Pixel::ALPHA);
+	engine.SetPixelBlend(0.8f);
+	engine.SetDrawTarget(&drawn);
+	for (int y = 0; y < src.height; y++) {
+		for (int x = 0; x < src.width; x++) {
+			engine.Draw(x, y, src.GetPixel(x, y));
+		}
+	}
+	std::copy(d, d + count, out.data());
+	olc::PixelBlend(out.data(), a, count, 0.8f);
+	if (!std::equal(out.begin(), out.end(), drawn.GetData())) {
+		std::printf("olc::PixelBlend disagrees with Draw in ALPHA mode\n");
+		failures++;
+	}
+
+	Measure("Pixel::operator*/screen", [&] {
+		for (size_t i = 0; i < count; i++) {
+			out[i] = a[i] * 0.6f;
+		}
+		sink += out[0].n;
+	});
+	Measure("olc::PixelScale/screen", [&] {
+		olc::PixelScale(out.data(), a, count, 0.6f);
+		sink += out[0].n;
+	});
+	Measure("olc::PixelLerp/screen", [&] {
+		olc::PixelLerp(out.data(), a, d, count, 0.3f);
+		sink += out[0].n;
+	});
+	Measure("Draw ALPHA/screen", [&] {
+		for (int y = 0; y < src.height; y++) {
+			for (int x = 0; x < src.width; x++) {
+				engine.Draw(x, y, src.GetPixel(x, y));
+			}
+		}
+		sink += drawn.GetData()[0].n;
+	});
+	Measure("DrawSprite ALPHA/screen", [&] {
+		engine.DrawSprite(0, 0, &src);
+		sink += drawn.GetData()[0].n;
+	});
+	Measure("FillRect ALPHA/screen", [&] {
+		engine.FillRect(0, 0, src.width, src.height, olc::Pixel(200, 100, 50, 128));
+		sink += drawn.GetData()[0].n;
+	});
+	Measure("FillTriangle ALPHA/half screen", [&] {
+		engine.FillTriangle(0, 0, src.width - 1, 0, 0, src.height - 1, olc::Pixel(200, 100, 50, 128));
+		sink += drawn.GetData()[0].n;
+	});
+
+	engine.SetDrawTarget(nullptr);
+	engine.SetPixelBlend(1.0f);
+	engine.SetPixelMode(olc::Pixel::NORMAL);
+}
+
+bool SaveResults(const std::string& path) {
+	std::ofstream out(path);
+	if (!out) {
+		return false;
+	}
+
+	out << "[\n";
+	for (size_t i = 0; i < results.size(); i++) {
+		const auto& r = results[i];
+		out << "\t{\"name\": \"" << r.name << "\", \"ns_per_op\": " << r.ns_per_op
+			<< ", \"allocs_per_op\": " << r.allocs_per_op << ", \"bytes_per_op\": " << r.bytes_per_op << "}"
+			<< (i + 1 < results.size() ? ",\n" : "\n");
+	}
+	out << "]\n";
+	return true;
+}
+
+// Reads back the one-result-per-line format written by SaveResults
+std::map<std::string, BenchResult> LoadResults(const std::string& path) {
+	std::map<std::string, BenchResult> loaded;
+	std::ifstream in(path);
+	std::string line;
+
+	auto field = [](const std::string& line, const std::string& key) {
+		size_t pos = line.find("\"" + key + "\": ");
+		return pos == std::string::npos ? 0.0 : std::atof(line.c_str() + pos + key.size() + 4);
+	};
+
+	while (std::getline(in, line)) {
+		size_t start = line.find("\"name\": \"");
+		if (start == std::string::npos) {
+			continue;
+		}
+		start += 9;
+		BenchResult r;
+		r.name = line.substr(start, line.find('"', start) - start);
+		r.ns_per_op = field(line, "ns_per_op");
+		r.allocs_per_op = field(line, "allocs_per_op");
+		r.bytes_per_op = field(line, "bytes_per_op");
+		loaded[r.name] = r;
+	}
+
+	return loaded;
+}
+
+// Returns the number of benchmarks that got slower than the threshold or allocate more
+int CompareResults(const std::map<std::string, BenchResult>& baseline, double threshold) {
+	int regressions = 0;
+
+	std::printf("\n%-56s %12s %12s %8s\n", "Compared to baseline", "base ns", "now ns", "delta");
+	for (const auto& r : results) {
+		auto it = baseline.find(r.name);
+		if (it == baseline.end()) {
+			std::printf("%-56s %12s %12.1f %8s\n", r.name.c_str(), "-", r.ns_per_op, "new");
+			continue;
+		}
+
+		const auto& b = it->second;
+		double delta = b.ns_per_op > 0.0 ? (r.ns_per_op - b.ns_per_op) / b.ns_per_op : 0.0;
+		bool slower = delta > threshold;
+		bool allocates = r.allocs_per_op > b.allocs_per_op + 0.01;
+		regressions += (slower || allocates) ? 1 : 0;
+
+		std::printf("%-56s %12.1f %12.1f %+7.1f%%%s%s\n", r.name.c_str(), b.ns_per_op, r.ns_per_op, delta * 100.0,
+			slower ? "  SLOWER" : "", allocates ? "  MORE ALLOCS" : "");
+	}
+
+	return regressions;
+}
+
+int main(int argc, char* argv[]) {
+	std::string save_path;
+	std::string baseline_path;
+	double threshold = 0.15;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--filter" && i + 1 < argc) {
+			filter = argv[++i];
+		}
+		else if (arg == "--save" && i + 1 < argc) {
+			save_path = argv[++i];
+		}
+		else if (arg == "--baseline" && i + 1 < argc) {
+			baseline_path = argv[++i];
+		}
+		else if (arg == "--threshold" && i + 1 < argc) {
+			threshold = std::atof(argv[++i]) / 100.0;
+		}
+		else {
+			std::printf("usage: %s [--filter text] [--save file] [--baseline file] [--threshold percent]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	BenchEngine engine;
+	engine.Construct(256, 240, 1, 1);
+	engine.olc_PrepareEngine();
+	InitializeCards();
+
+	BenchDeck();
+	BenchIsValid();
+	BenchScore();
+	BenchLayout();
+	BenchTween();
+	BenchSim();
+	BenchSearch();
+	BenchDraw(engine);
+	BenchPixels(engine);
+
+	if (failures > 0) {
+		return 1;
+	}
+
+	if (!save_path.empty() && !SaveResults(save_path)) {
+		std::printf("Could not write %s\n", save_path.c_str());
+		return 2;
+	}
+
+	if (!baseline_path.empty()) {
+		auto baseline = LoadResults(baseline_path);
+		if (baseline.empty()) {
+			std::printf("Could not read %s\n", baseline_path.c_str());
+			return 2;
+		}
+		int regressions = CompareResults(baseline, threshold);
+		if (regressions > 0) {
+			std::printf("\n%d benchmark(s) regressed\n", regressions);
+			return 1;
+		}
+	}
+
+	return 0;
+}
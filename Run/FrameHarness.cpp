@@ -0,0 +1,389 @@
+// Scripted-input frame time regression harness.
+//
+// Links the real Run class with the headless platform and the software
+// renderer, then replays a recorded input script through olc_CoreUpdate one
+// frame at a time.  Frame times and heap allocations are reported per game
+// state and checked against the budgets in the script.
+//
+// Build (from the repository root):
+//	g++ -std=c++17 -O2 Run/FrameHarness.cpp -o frame_harness -lpthread
+//	cl /std:c++17 /O2 /EHsc Run\FrameHarness.cpp
+//
+// Usage:
+//	frame_harness <script> [--budget STATE=ms]...
+//	frame_harness --record <script> [--seed N] [--length N]
+//
+// Script format, one command per line, # starts a comment:
+//	seed <n>                          seed for the game rng
+//	step <seconds>                    fixed time step per frame
+//	mouse <frame> <x> <y> <0|1>       mouse position and left button from <frame> on
+//	end <frame>                       number of frames to run
+//	budget <STATE|ALL> <p99 ms> [max allocs per frame]
+//
+// Recording plays start screen -> length select -> a full game -> tutorial
+// with a simple bot.  Shuffles are not stable across standard libraries, so
+// a script recorded with one compiler may drift when replayed with another.
+
+#define OLC_PGE_HEADLESS
+#include "olcPixelGameEngine.h"
+#include "SoftwareRenderer.h"
+
+#define OLC_GFX_CUSTOM_EX
+#define OLC_RENDERER_CUSTOM_EX olc::Renderer_Software
+#define OLC_PGE_APPLICATION
+#include "olcPixelGameEngine.h"
+#define OLC_PGEX_TRANSFORMEDVIEW
+#include "olcPGEX_TransformedView.h"
+
+#define RUN_ALLOC_STATS_IMPLEMENTATION
+#include "AllocStats.h"
+#include "Game.h"
+#include "Run.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <optional>
+#include <sstream>
+
+struct MouseEvent {
+	int frame;
+	olc::vi2d pos;
+	bool down;
+};
+
+struct Budget {
+	std::string state; // "ALL" applies to every state
+	double p99_ms = 0.0;
+	int64_t max_allocs = -1;
+};
+
+struct Script {
+	uint32_t seed = 1;
+	float step = 1.0f / 60.0f;
+	int end_frame = 0;
+	std::vector<MouseEvent> events;
+	std::vector<Budget> budgets;
+};
+
+std::optional<Script> LoadScript(const std::string& path) {
+	std::ifstream in(path);
+	if (!in) {
+		return std::nullopt;
+	}
+
+	Script script;
+	std::string line;
+	while (std::getline(in, line)) {
+		line = line.substr(0, line.find('#'));
+		std::istringstream ss(line);
+		std::string command;
+		if (!(ss >> command)) {
+			continue;
+		}
+
+		if (command == "seed") {
+			ss >> script.seed;
+		}
+		else if (command == "step") {
+			ss >> script.step;
+		}
+		else if (command == "end") {
+			ss >> script.end_frame;
+		}
+		else if (command == "mouse") {
+			MouseEvent e;
+			int down = 0;
+			ss >> e.frame >> e.pos.x >> e.pos.y >> down;
+			e.down = down != 0;
+			script.events.push_back(e);
+		}
+		else if (command == "budget") {
+			Budget b;
+			ss >> b.state >> b.p99_ms;
+			if (!(ss >> b.max_allocs)) {
+				b.max_allocs = -1;
+			}
+			script.budgets.push_back(b);
+		}
+		else {
+			std::printf("Unknown script command '%s'\n", command.c_str());
+			return std::nullopt;
+		}
+	}
+
+	return script;
+}
+
+// The game, driven by hand instead of through Start()
+class HarnessRun : public Run {
+public:
+	bool Setup(float step) {
+		if (!Construct(256, 240, 1, 1)) {
+			return false;
+		}
+		olc_UpdateWindowSize(256, 240);
+		olc_PrepareEngine();
+		fixed_time_step = step;
+		return OnUserCreate();
+	}
+
+	void SetMouse(const olc::vi2d& pos, bool down) {
+		olc_UpdateMouse(pos.x, pos.y);
+		olc_UpdateMouseState(0, down);
+	}
+};
+
+struct FrameSample {
+	GameState state;
+	double ms;
+	uint64_t allocs;
+};
+
+// Plays through the title screen, a whole game and the tutorial, choosing
+// where to click from the live game state
+struct RecordingBot {
+	enum class Phase { START_GAME, PLAYING, START_TUTORIAL, TUTORIAL, DONE };
+
+	Phase phase = Phase::START_GAME;
+	int length_button_y = 132; // "Too Long"
+
+	std::optional<olc::vi2d> Click(GameState state) {
+		switch (state) {
+		case GameState::START_SCREEN:
+			if (phase == Phase::START_GAME) {
+				phase = Phase::PLAYING;
+				return olc::vi2d{ 128, 180 };
+			}
+			if (phase == Phase::START_TUTORIAL) {
+				phase = Phase::TUTORIAL;
+				return olc::vi2d{ 128, 212 };
+			}
+			if (phase == Phase::TUTORIAL) {
+				phase = Phase::DONE;
+			}
+			return std::nullopt;
+
+		case GameState::LENGTH_SELECT:
+			return olc::vi2d{ 128, length_button_y };
+
+		case GameState::PICK_CARD:
+			for (const auto& c : hand.cards) {
+				if (in_play.cards.empty() || IsValid(in_play.cards.back(), c)) {
+					return olc::vi2d(c.position + card_size / 2.0f);
+				}
+			}
+			if (in_play.cards.size() > 2) {
+				return olc::vi2d{ 42, 198 }; // End Turn
+			}
+			return olc::vi2d{ 214, 198 }; // Discard
+
+		case GameState::END_GAME:
+			phase = Phase::START_TUTORIAL;
+			return olc::vi2d{ 128, 180 }; // Restart
+
+		case GameState::TUTORIAL:
+			return olc::vi2d{ 128, 120 };
+
+		default:
+			return std::nullopt;
+		}
+	}
+};
+
+int Record(const std::string& path, uint32_t seed, int length) {
+	const float step = 1.0f / 60.0f;
+	const int max_frames = 500000;
+
+	rng.seed(seed);
+	HarnessRun game;
+	if (!game.Setup(step)) {
+		std::printf("Could not set up the game\n");
+		return 2;
+	}
+
+	RecordingBot bot;
+	const std::array<std::pair<int, int>, 4> length_buttons = { { {5, 96}, {6, 108}, {7, 120}, {9, 132} } };
+	for (const auto& [value, y] : length_buttons) {
+		if (value == length) {
+			bot.length_button_y = y;
+		}
+	}
+
+	std::ofstream out(path);
+	if (!out) {
+		std::printf("Could not write %s\n", path.c_str());
+		return 2;
+	}
+	out << "# Recorded by frame_harness --record\n";
+	out << "seed " << seed << "\n";
+	out << "step " << step << "\n";
+
+	olc::vi2d mouse = { 0, 0 };
+	bool pressed_last_frame = false;
+	int frame = 0;
+
+	for (; frame < max_frames && bot.phase != RecordingBot::Phase::DONE; frame++) {
+		if (pressed_last_frame) {
+			game.SetMouse(mouse, false);
+			out << "mouse " << frame << " " << mouse.x << " " << mouse.y << " 0\n";
+			pressed_last_frame = false;
+		}
+		else if (auto target = bot.Click(game.current_state)) {
+			mouse = *target;
+			game.SetMouse(mouse, true);
+			out << "mouse " << frame << " " << mouse.x << " " << mouse.y << " 1\n";
+			pressed_last_frame = true;
+		}
+
+		game.olc_CoreUpdate();
+	}
+
+	out << "end " << frame << "\n";
+	std::printf("Recorded %d frames to %s\n", frame, path.c_str());
+	return frame < max_frames ? 0 : 1;
+}
+
+double Percentile(std::vector<double> values, double p) {
+	if (values.empty()) {
+		return 0.0;
+	}
+	std::sort(values.begin(), values.end());
+	size_t index = std::min(values.size() - 1, size_t(p * (values.size() - 1) + 0.5));
+	return values[index];
+}
+
+int Replay(const Script& script, const std::vector<Budget>& extra_budgets) {
+	rng.seed(script.seed);
+	HarnessRun game;
+	if (!game.Setup(script.step)) {
+		std::printf("Could not set up the game\n");
+		return 2;
+	}
+
+	std::vector<FrameSample> samples;
+	samples.reserve(script.end_frame);
+
+	size_t next_event = 0;
+	for (int frame = 0; frame < script.end_frame; frame++) {
+		while (next_event < script.events.size() && script.events[next_event].frame <= frame) {
+			game.SetMouse(script.events[next_event].pos, script.events[next_event].down);
+			next_event++;
+		}
+
+		GameState state = game.current_state;
+		auto allocs_before = alloc_stats::Snapshot();
+		auto start = std::chrono::steady_clock::now();
+		game.olc_CoreUpdate();
+		auto end = std::chrono::steady_clock::now();
+		auto allocs = alloc_stats::Snapshot() - allocs_before;
+
+		samples.push_back({ state, std::chrono::duration<double, std::milli>(end - start).count(), allocs.count });
+	}
+
+	// Group the samples per state, plus an overall entry
+	std::map<std::string, std::vector<double>> times;
+	std::map<std::string, std::vector<uint64_t>> allocs;
+	for (const auto& s : samples) {
+		for (const std::string& key : { std::string(GameStateName(s.state)), std::string("ALL") }) {
+			times[key].push_back(s.ms);
+			allocs[key].push_back(s.allocs);
+		}
+	}
+
+	std::printf("%-16s %8s %9s %9s %9s %9s %12s %12s\n", "state", "frames", "p50 ms", "p90 ms", "p99 ms", "max ms", "allocs/frame", "max allocs");
+	for (const auto& [state, t] : times) {
+		const auto& a = allocs[state];
+		double mean_allocs = 0.0;
+		for (auto n : a) {
+			mean_allocs += double(n);
+		}
+		mean_allocs /= a.size();
+
+		std::printf("%-16s %8zu %9.3f %9.3f %9.3f %9.3f %12.1f %12llu\n", state.c_str(), t.size(),
+			Percentile(t, 0.50), Percentile(t, 0.90), Percentile(t, 0.99), Percentile(t, 1.0),
+			mean_allocs, (unsigned long long)*std::max_element(a.begin(), a.end()));
+	}
+
+	std::vector<Budget> budgets = script.budgets;
+	budgets.insert(budgets.end(), extra_budgets.begin(), extra_budgets.end());
+
+	int failures = 0;
+	for (const auto& b : budgets) {
+		auto it = times.find(b.state);
+		if (it == times.end()) {
+			std::printf("FAIL %s: no frames were spent in this state\n", b.state.c_str());
+			failures++;
+			continue;
+		}
+
+		double p99 = Percentile(it->second, 0.99);
+		if (b.p99_ms > 0.0 && p99 > b.p99_ms) {
+			std::printf("FAIL %s: p99 %.3f ms exceeds budget of %.3f ms\n", b.state.c_str(), p99, b.p99_ms);
+			failures++;
+		}
+
+		const auto& a = allocs[b.state];
+		uint64_t max_allocs = *std::max_element(a.begin(), a.end());
+		if (b.max_allocs >= 0 && max_allocs > uint64_t(b.max_allocs)) {
+			std::printf("FAIL %s: %llu allocations in one frame exceeds budget of %lld\n", b.state.c_str(), (unsigned long long)max_allocs, (long long)b.max_allocs);
+			failures++;
+		}
+	}
+
+	return failures > 0 ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+	std::string script_path;
+	std::string record_path;
+	uint32_t seed = 1;
+	int length = 9;
+	std::vector<Budget> budgets;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--record" && i + 1 < argc) {
+			record_path = argv[++i];
+		}
+		else if (arg == "--seed" && i + 1 < argc) {
+			seed = uint32_t(std::stoul(argv[++i]));
+		}
+		else if (arg == "--length" && i + 1 < argc) {
+			length = std::stoi(argv[++i]);
+		}
+		else if (arg == "--budget" && i + 1 < argc) {
+			std::string spec = argv[++i];
+			size_t eq = spec.find('=');
+			if (eq == std::string::npos) {
+				std::printf("Budgets look like STATE=ms\n");
+				return 2;
+			}
+			budgets.push_back({ spec.substr(0, eq), std::stod(spec.substr(eq + 1)), -1 });
+		}
+		else if (arg[0] != '-' && script_path.empty()) {
+			script_path = arg;
+		}
+		else {
+			std::printf("usage: %s <script> [--budget STATE=ms]...\n       %s --record <script> [--seed N] [--length N]\n", argv[0], argv[0]);
+			return 2;
+		}
+	}
+
+	if (!record_path.empty()) {
+		return Record(record_path, seed, length);
+	}
+
+	if (script_path.empty()) {
+		std::printf("No script given\n");
+		return 2;
+	}
+
+	auto script = LoadScript(script_path);
+	if (!script) {
+		std::printf("Could not read %s\n", script_path.c_str());
+		return 2;
+	}
+
+	return Replay(*script, budgets);
+}
@@ -0,0 +1,639 @@
+#pragma once
+
+// Cards, rules, scoring and the shared game globals.  Kept separate from the
+// states in Run.h so tools such as the benchmarks can link the real rules.
+
+#include "Trace.h"
+#include "olcPixelGameEngine.h"
+#include "olcPGEX_TransformedView.h"
+#include "Sim.h"
+
+#include <algorithm>
+#include <charconv>
+#include <random>
+#include <string_view>
+#include <unordered_map>
+
+inline std::random_device rd;
+inline std::mt19937 rng(rd());
+
+struct Rule {
+	std::string text;
+	std::string key;
+
+	// Some value specific to the rule
+	int value = 0;
+	bool tick_on_end = true; // tick at the end of a turn
+	bool tick_on_play = false; // tick after a card is played (play animation completed)
+};
+
+// Transparent comparison so rules can be looked up by literal without building a std::string
+using RuleMap = std::map<std::string, Rule, std::less<>>;
+
+// Values and ticking must match sim::rule_info
+inline RuleMap possible_rules = {
+	{"no_unplay", {"No take backs", "no_unplay", 7, false, true}},
+	{"monochrome", {"Monochromatic", "monochrome", 2}},
+	{"double_length", {"2x length score", "double_length", 1}},
+	{"double_number", {"2x number score", "double_number", 2}},
+	{"double_letter", {"2x letter score", "double_letter", 2}},
+	{"double_shape", {"2x shape score", "double_shape", 2}},
+	{"double_color", {"2x color score ", "double_color", 2}},
+	{"discard_to_deck", {"Discard to deck", "discard_to_deck", 1}},
+	{"run_backwards", {"Run Backwards", "run_backwards", 3}},
+	{"carbon_copy", {"Carbon copy", "carbon_copy", 1}},
+	{"double_jump", {"Double jump", "double_jump", 1}},
+	{"timed_turn", {"Hurry hurry!", "timed_turn", 3}},
+};
+
+inline RuleMap enabled_rules;
+
+inline void TickRule(std::string_view rule_name) {
+	auto rule = enabled_rules.find(rule_name);
+	if (rule != enabled_rules.end()) {
+		rule->second.value -= 1;
+		if (rule->second.value < 0) {
+			enabled_rules.erase(rule);
+		}
+	}
+}
+
+inline bool RuleEnabled(std::string_view rule_name) {
+	return enabled_rules.count(rule_name) > 0;
+}
+
+// The enabled rules as a sim::RuleBit mask
+inline uint32_t EnabledRuleMask() {
+	uint32_t mask = 0;
+	for (const auto& [key, rule] : enabled_rules) {
+		sim::RuleBit bit = sim::RuleIndex(key);
+		mask |= bit < sim::RULE_COUNT ? sim::Bit(bit) : 0u;
+	}
+	return mask;
+}
+
+inline void DrawRules(olc::PixelGameEngine* pge, const RuleMap& rules) {
+	float y_pos = 10.0f;
+	float x_pos = 184.0f;
+	float y_increment = 12.0f;
+
+	if (rules.size() == 0) {
+		static const std::string str = "No Special Rules";
+		olc::vf2d str_size = pge->GetTextSize(str);
+		olc::vf2d draw_pos = { x_pos - str_size.x / 2.0f, y_pos };
+		pge->DrawStringDecal(draw_pos, str);
+	}
+	else {
+		for (const auto& rule : rules) {
+			olc::vf2d str_size = pge->GetTextSize(rule.second.text);
+			olc::vf2d draw_pos = { x_pos - str_size.x / 2.0f, y_pos };
+			pge->DrawStringDecal(draw_pos, rule.second.text);
+			y_pos += y_increment;
+		}
+	}
+}
+
+inline bool PointInRect(const olc::vf2d point, const olc::vf2d& pos, const olc::vf2d& size) {
+	if (point.x >= pos.x && point.y >= pos.y && point.x < pos.x + size.x && point.y < pos.y + size.y) {
+		return true;
+	}
+
+	return false;
+}
+
+// The regular polygons drawn on cards, one for each side count.  Every shape
+// lives in one table built at compile time, a primitive is a view into it.
+constexpr int min_shape_sides = 3;
+constexpr int max_shape_sides = 11;
+
+struct ShapePrimitive {
+	int sides = 0;
+	const olc::vf2d* points = nullptr; // sides points around the centre, in fan order
+	const olc::vf2d* uv = nullptr;
+	const uint8_t* indices = nullptr;  // sides - 2 triangles as a list of points
+};
+
+// std::sin is not constexpr.  x is reduced to [-pi, pi] first, where the
+// series is far past float precision by its 17th term.
+constexpr double ConstSin(double x) {
+	constexpr double pi = 3.14159265358979323846;
+	while (x > pi) {
+		x -= 2.0 * pi;
+	}
+	while (x < -pi) {
+		x += 2.0 * pi;
+	}
+	double term = x;
+	double sum = x;
+	for (int n = 1; n < 17; n++) {
+		term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+		sum += term;
+	}
+	return sum;
+}
+
+constexpr double ConstCos(double x) {
+	return ConstSin(x + 3.14159265358979323846 / 2.0);
+}
+
+struct ShapeTable {
+	static constexpr int point_count = (max_shape_sides * (max_shape_sides + 1) - (min_shape_sides - 1) * min_shape_sides) / 2;
+	static constexpr int index_count = 3 * (point_count - 2 * (max_shape_sides - min_shape_sides + 1));
+
+	std::array<olc::vf2d, point_count> points{};
+	std::array<olc::vf2d, point_count> uv{};
+	std::array<uint8_t, index_count> indices{};
+	// Where each side count starts in points and uv, and in indices
+	std::array<int, max_shape_sides + 1> first_point{};
+	std::array<int, max_shape_sides + 1> first_index{};
+};
+
+constexpr ShapeTable MakeShapeTable(float shape_size = 10.0f) {
+	ShapeTable table;
+	int point = 0;
+	int index = 0;
+	for (int sides = min_shape_sides; sides <= max_shape_sides; sides++) {
+		table.first_point[sides] = point;
+		table.first_index[sides] = index;
+		float val = (2.0f * 3.14159f) / sides;
+		for (int i = 0; i < sides; i++) {
+			double s = ConstSin(i * val);
+			double c = ConstCos(i * val);
+			table.points[point + i] = { float(shape_size * s), float(shape_size * c) };
+			table.uv[point + i] = { float((s + 1.0) / 2.0), float((c + 1.0) / 2.0) };
+		}
+		for (int i = 1; i + 1 < sides; i++) {
+			table.indices[index++] = 0;
+			table.indices[index++] = uint8_t(i);
+			table.indices[index++] = uint8_t(i + 1);
+		}
+		point += sides;
+	}
+	return table;
+}
+
+inline constexpr ShapeTable shape_table = MakeShapeTable();
+
+constexpr std::array<ShapePrimitive, max_shape_sides + 1> MakeShapePrimitives() {
+	std::array<ShapePrimitive, max_shape_sides + 1> primitives{};
+	for (int sides = min_shape_sides; sides <= max_shape_sides; sides++) {
+		primitives[sides] = {
+			sides,
+			&shape_table.points[shape_table.first_point[sides]],
+			&shape_table.uv[shape_table.first_point[sides]],
+			&shape_table.indices[shape_table.first_index[sides]],
+		};
+	}
+	return primitives;
+}
+
+// Indexed by side count, min_shape_sides to max_shape_sides
+inline constexpr std::array<ShapePrimitive, max_shape_sides + 1> shape_primitives = MakeShapePrimitives();
+
+struct Shape {
+	const ShapePrimitive* primitive;
+	olc::Pixel color;
+	int color_index;
+};
+
+inline olc::vf2d card_size = { 25.0f, 35.0f };
+inline float fTurnStart = 0.0f;
+inline float fTotalTime = 0.0f;
+
+inline std::array<olc::Pixel, 7> card_colors = {
+	olc::Pixel{142, 68, 173},
+	olc::Pixel{41, 128, 185},
+	olc::Pixel{93, 173, 226},
+	olc::Pixel{39, 174, 96},
+	olc::Pixel{241, 196, 15},
+	olc::Pixel{230, 126, 34},
+	olc::Pixel{231, 76, 60}
+};
+
+// These will be filled in automatically based on the card colors
+inline std::array<olc::Pixel, 7> shape_colors;
+
+// Text for card numbers and letters, built once so drawing a card does not create strings
+inline const std::string& NumberString(int number) {
+	static const std::array<std::string, 100> strings = [] {
+		std::array<std::string, 100> s;
+		for (int i = 0; i < 100; i++) {
+			s[i] = std::to_string(i);
+		}
+		return s;
+	}();
+	return strings[std::clamp(number, 0, 99)];
+}
+
+inline const std::string& LetterString(char letter) {
+	static const std::array<std::string, 128> strings = [] {
+		std::array<std::string, 128> s;
+		for (int i = 0; i < 128; i++) {
+			s[i] = std::string(1, static_cast<char>(i));
+		}
+		return s;
+	}();
+	return strings[letter & 127];
+}
+
+// A prefixed number that only rebuilds its text when the number changes
+struct Label {
+	std::string prefix;
+	std::string text;
+	int value = 0;
+	bool valid = false;
+
+	explicit Label(std::string prefix_) : prefix(std::move(prefix_)) {
+		text.reserve(prefix.size() + 16);
+	}
+
+	const std::string& Get(int new_value) {
+		if (!valid || new_value != value) {
+			char digits[16];
+			auto end = std::to_chars(std::begin(digits), std::end(digits), new_value).ptr;
+			text.assign(prefix).append(digits, end);
+			value = new_value;
+			valid = true;
+		}
+		return text;
+	}
+};
+
+struct Card {
+	olc::vf2d size;
+	Shape shape;
+	olc::Pixel color;
+	int number;
+	char letter;
+	olc::vf2d position;
+	bool locked; // prevents taking back the card if played
+	// Drawn size about the top-left corner, changed while the card moves
+	// between the hand and the zoomed row in play
+	olc::vf2d scale = { 1.0f, 1.0f };
+
+	// pos is top-left position
+	void Draw(olc::PixelGameEngine* pge, float dim = 1.0f) const {
+		if (scale == olc::vf2d{ 1.0f, 1.0f }) {
+			DrawOn(*pge, dim);
+		}
+		else {
+			DrawScaled({ 0.0f, 0.0f }, { 1.0f, 1.0f }, dim);
+		}
+	}
+
+	// As above with position in the view's world space
+	void Draw(olc::TransformedView& view, float dim = 1.0f) const {
+		if (scale == olc::vf2d{ 1.0f, 1.0f }) {
+			DrawOn(view, dim);
+		}
+		else {
+			DrawScaled(view.GetWorldOffset(), view.GetWorldScale(), dim);
+		}
+	}
+
+	// Draws through a view that adds scale to one with the given offset and
+	// scale, keeping the top-left corner where that one puts it
+	void DrawScaled(const olc::vf2d& offset, const olc::vf2d& view_scale, float dim) const {
+		static olc::TransformedView scaled;
+		scaled.SetWorldScale(view_scale * scale);
+		scaled.SetWorldOffset(position - (position - offset) / scale);
+		DrawOn(scaled, dim);
+	}
+
+	// canvas is the engine or a view, they share the decal calls
+	template <typename Canvas>
+	void DrawOn(Canvas& canvas, float dim) const {
+		bool monochrome = RuleEnabled("monochrome");
+		olc::Pixel shape_color = monochrome ? olc::VERY_DARK_GREY : shape.color;
+		olc::Pixel card_color = monochrome ? olc::GREY : color;
+
+		canvas.FillRectDecal(position, size, card_color * dim);
+
+		//draw the shape
+		std::array<olc::vf2d, max_shape_sides> points;
+		for (int i = 0; i < shape.primitive->sides; i++) {
+			points[i] = shape.primitive->points[i] + position + size / 2.0f;
+		}
+		canvas.DrawPolygonDecal(nullptr, points.data(), shape.primitive->uv, uint32_t(shape.primitive->sides), shape_color * dim);
+
+		olc::vf2d tl = { 2.0f, 2.0f };
+
+		//draw the number
+		canvas.DrawStringDecal(position + tl, NumberString(number), olc::WHITE * dim);
+
+		//draw the letter
+		canvas.DrawStringDecal(position - tl + size - olc::vf2d{8.0f, 8.0f}, LetterString(letter), olc::WHITE * dim);
+	}
+
+	bool operator==(const Card& other) {
+		return number == other.number && shape.primitive == other.shape.primitive && letter == other.letter && color == other.color;
+	}
+};
+
+// Builds the shape colors every card refers to
+inline void InitializeCards() {
+	olc::PixelScale(shape_colors.data(), card_colors.data(), card_colors.size(), 0.6f);
+}
+
+inline std::vector<Card> CreateDeck(int num_numbers, int num_letters, int num_shapes) {
+	RUN_TRACE_SCOPE("CreateDeck");
+	std::vector<Card> deck;
+	deck.reserve(num_numbers * num_letters * num_shapes);
+
+	int counter = 0;
+
+	for (int n = 0; n < num_numbers; n++) {
+		for (int l = 0; l < num_letters; l++) {
+			for (int s = 0; s < num_shapes; s++) {
+				Card c;
+				c.shape.primitive = &shape_primitives[s + 3];
+				c.number = n + 1;
+				c.letter = "ABCDEFGHI"[l];
+				c.size = card_size;
+
+				auto color_index = counter % 7;
+				c.shape.color = shape_colors[color_index];
+				c.shape.color_index = color_index;
+				c.color = card_colors[color_index];
+				counter++;
+				deck.push_back(c);
+			}
+		}
+	}
+
+	return deck;
+}
+
+// A deck kept in uniformly random order.  Cards are drawn from the back and
+// returned cards are swapped into a random slot, so the order stays uniform
+// without reshuffling and returning k cards costs O(k) whatever the deck size.
+struct Deck {
+	std::vector<Card> cards;
+
+	size_t size() const { return cards.size(); }
+	bool empty() const { return cards.empty(); }
+	void clear() { cards.clear(); }
+
+	Card Pop() {
+		Card c = cards.back();
+		cards.pop_back();
+		return c;
+	}
+
+	template <typename URBG>
+	void Insert(const Card& c, URBG& g) {
+		cards.push_back(c);
+		size_t slot = std::uniform_int_distribution<size_t>(0, cards.size() - 1)(g);
+		std::swap(cards[slot], cards.back());
+	}
+
+	template <typename It, typename URBG>
+	void Insert(It first, It last, URBG& g) {
+		cards.reserve(cards.size() + std::distance(first, last));
+		for (; first != last; ++first) {
+			Insert(*first, g);
+		}
+	}
+
+	template <typename URBG>
+	void Shuffle(URBG& g) {
+		std::shuffle(std::begin(cards), std::end(cards), g);
+	}
+};
+
+// deck, and the cards leaving the table at the end of a turn
+inline Deck the_deck;
+inline std::vector<Card> the_discard;
+
+
+// The values the rules look at, see Sim.h
+inline sim::Card ToSim(const Card& c) {
+	return { int8_t(c.number), int8_t(c.letter - 'A'), int8_t(c.shape.primitive->sides), int8_t(c.shape.color_index) };
+}
+
+// Checks if the choice card would be valid if played after the end_card
+inline bool IsValid(const Card& end_card, const Card& choice) {
+	return sim::IsValid(ToSim(end_card), ToSim(choice), EnabledRuleMask());
+}
+
+// The cards that have already been played this round
+struct InPlay {
+	std::vector<Card> cards;
+	olc::vf2d position = { 128.0f, 120.0f };
+
+	// The cards are drawn through view, which zooms out once the row is
+	// wider than the screen.  Below min_zoom it follows the end of the row
+	// instead and cards off the screen are not drawn.
+	olc::TransformedView view;
+	static constexpr float min_zoom = 0.4f;
+
+	void Add(Card c) {
+		if (cards.size()) {
+			cards.back().locked = true;
+		}
+
+		if (RuleEnabled("no_unplay")) {
+			c.locked = true;
+		}
+
+		c.scale = { 1.0f, 1.0f };
+		cards.push_back(c);
+
+		int cards_in_play = cards.size();
+		olc::vf2d start_pos = { position.x - cards_in_play * (card_size.x / 2.0f + 0.5f), position.y };
+		olc::vf2d increment = { card_size.x + 1.0f, 0.0f };
+
+		for (auto& c : cards) {
+			c.position = start_pos;
+			start_pos += increment;
+		}
+		Fit(cards_in_play);
+	}
+
+	// Fits view to a row of count cards laid out as Add does.  A row that
+	// fits the screen is drawn unscaled.
+	void Fit(int count) {
+		constexpr olc::vi2d view_area = { 256, 240 };
+		constexpr float margin = 2.0f;
+		float left = position.x - count * (card_size.x / 2.0f + 0.5f);
+		float width = count * (card_size.x + 1.0f);
+		float zoom = count > 0 ? std::clamp((view_area.x - 2.0f * margin) / width, min_zoom, 1.0f) : 1.0f;
+
+		// Zooms about the middle of the row, or keeps its end in view
+		olc::vf2d centre = { left + width / 2.0f, position.y + card_size.y / 2.0f };
+		olc::vf2d on_screen = { view_area.x / 2.0f, centre.y };
+		if (width * zoom > view_area.x - 2.0f * margin) {
+			on_screen.x = view_area.x - margin - width * zoom / 2.0f;
+		}
+		view.SetViewArea(view_area);
+		view.SetWorldScale({ zoom, zoom });
+		view.SetWorldOffset(centre - on_screen / zoom);
+	}
+
+	void Draw(olc::PixelGameEngine* pge) {
+		for (const auto& c : cards) {
+			if (view.IsRectVisible(c.position, c.size * c.scale)) {
+				c.Draw(view, c.locked ? 0.3f : 1.0f);
+			}
+		}
+	}
+};
+
+inline InPlay in_play;
+
+//Cards in hand
+struct Hand {
+	std::vector<Card> cards;
+	int max_size = 7;
+	olc::vf2d position = { 128.0f, 205.0f };
+
+	void Add(Card c) {
+		c.locked = false;
+		c.scale = { 1.0f, 1.0f };
+		cards.push_back(c);
+
+		int cards_in_hand = cards.size();
+		olc::vf2d start_pos = { position.x - cards_in_hand * (card_size.x / 2.0f + 0.5f), position.y };
+		olc::vf2d increment = { card_size.x + 1.0f, 0.0f };
+
+		for (auto& c : cards) {
+			c.position = start_pos;
+			start_pos += increment;
+		}
+	}
+
+	// Bit i set when cards[i] can be played after the last card in play
+	uint32_t PlayableMask() const {
+		int count = std::min<int>(cards.size(), sim::mask_cards);
+		if (in_play.cards.size() == 0) {
+			return (1u << count) - 1;
+		}
+		sim::HandLanes sim_cards{};
+		for (int i = 0; i < count; i++) {
+			sim_cards[i] = ToSim(cards[i]);
+		}
+		return sim::PlayableMask(ToSim(in_play.cards.back()), sim_cards.data(), count, EnabledRuleMask());
+	}
+
+	// Cards that can not be played are dimmed and cards[hint] is outlined
+	void Draw(olc::PixelGameEngine* pge, int hint = -1) {
+		uint32_t playable = PlayableMask();
+		for (size_t i = 0; i < cards.size(); i++) {
+			cards[i].Draw(pge, (playable & (1u << i)) ? 1.0f : 0.3f);
+		}
+		if (hint >= 0 && hint < int(cards.size())) {
+			pge->DrawRectDecal(cards[hint].position - olc::vf2d{ 1.0f, 1.0f }, cards[hint].size + olc::vf2d{ 2.0f, 2.0f }, olc::YELLOW);
+		}
+	}
+};
+
+inline void DrawColorPanel(olc::PixelGameEngine* pge, olc::vf2d center_top_pos) {
+	int color_count = card_colors.size();
+	olc::vf2d start_pos = { center_top_pos.x - color_count * 5.0f, center_top_pos.y };
+	olc::vf2d increment = { 10.0f, 0.0f };
+
+	bool monochrome = RuleEnabled("monochrome");
+
+	for (const auto& c : card_colors) {
+		pge->FillRectDecal(start_pos, { 10.0f, 10.0f }, monochrome ? olc::GREY : c);
+		start_pos += increment;
+	}
+}
+
+inline int Score(const std::vector<Card>& run) {
+	RUN_TRACE_SCOPE("Score");
+	sim::ScoreCounter counter;
+	for (const auto& c : run) {
+		counter.Add(ToSim(c));
+	}
+	return counter.Total(EnabledRuleMask());
+}
+
+inline int game_length = 5;
+// The players hand
+inline Hand hand;
+inline int score = 0;
+
+// Index into hand.cards for the card just played, for animation
+inline int card_played_index = -1;
+
+// Index into hand.cards of the card to highlight as a hint, -1 for none
+inline int hint_card = -1;
+
+// A second copy of the globals a game is played in, so a game can run without
+// touching the player's.  Swap exchanges it with the live globals, which
+// moves containers rather than copying them.
+struct GameContext {
+	std::mt19937 rng;
+	Deck deck;
+	std::vector<Card> discard;
+	Hand hand;
+	InPlay in_play;
+	RuleMap enabled_rules;
+	int game_length = 5;
+	int score = 0;
+	int card_played_index = -1;
+	float fTurnStart = 0.0f;
+
+	void Swap() {
+		std::swap(rng, ::rng);
+		std::swap(deck, the_deck);
+		std::swap(discard, the_discard);
+		std::swap(hand, ::hand);
+		std::swap(in_play, ::in_play);
+		std::swap(enabled_rules, ::enabled_rules);
+		std::swap(game_length, ::game_length);
+		std::swap(score, ::score);
+		std::swap(card_played_index, ::card_played_index);
+		std::swap(fTurnStart, ::fTurnStart);
+	}
+};
+
+// The buttons under the hand, drawn in every state of a game
+constexpr olc::vf2d end_button_pos = { 2.0f, 193.0f };
+constexpr olc::vf2d discard_button_pos = { 174.0f, 193.0f };
+constexpr olc::vf2d table_button_size = { 80.0f, 10.0f };
+
+inline void DrawEndButton(olc::PixelGameEngine* pge, bool button_active = false) {
+	pge->FillRectDecal(end_button_pos, table_button_size, button_active ? olc::DARK_GREY : olc::VERY_DARK_GREY);
+
+	constexpr olc::vf2d text_size = olc::TextSize("End Turn");
+	olc::vf2d scale = table_button_size / text_size;
+
+	pge->DrawStringDecal(end_button_pos + olc::vf2d{ 0.5f, 0.5f }, "End Turn", olc::BLACK, scale);
+}
+
+inline void DrawDiscardButton(olc::PixelGameEngine* pge, bool button_active = true) {
+	pge->FillRectDecal(discard_button_pos, table_button_size, button_active ? olc::DARK_GREY : olc::VERY_DARK_GREY);
+
+	constexpr olc::vf2d text_size = olc::TextSize("Discard");
+	olc::vf2d scale = table_button_size / text_size;
+
+	pge->DrawStringDecal(discard_button_pos + olc::vf2d{ 0.5f, 0.5f }, "Discard", olc::BLACK, scale);
+}
+
+inline int TurnTimeLeft() {
+	return 10 - static_cast<int>(std::floor(fTotalTime - fTurnStart));
+}
+
+inline void DrawNormalInterface(olc::PixelGameEngine* pge) {
+	DrawColorPanel(pge, { 128.0f, 193.0f });
+
+	// Leaving cards go under the ones still on the table
+	for (const auto& c : the_discard) {
+		c.Draw(pge);
+	}
+	in_play.Draw(pge);
+	hand.Draw(pge, hint_card);
+
+	static Label score_label{ "Score: " };
+	static Label deck_label{ "Deck : " };
+	static Label time_label{ "Time : " };
+
+	DrawRules(pge, enabled_rules);
+	pge->DrawStringDecal({ 10.0f, 10.0f }, score_label.Get(score));
+	pge->DrawStringDecal({ 10.0f, 20.0f }, deck_label.Get(static_cast<int>(the_deck.size())));
+	if (RuleEnabled("timed_turn")) {
+		pge->DrawStringDecal({ 10.0f, 30.0f }, time_label.Get(TurnTimeLeft()));
+	}
+}
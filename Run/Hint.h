@@ -0,0 +1,167 @@
+#pragma once
+
+// The in-game hint: which card in the hand the planner would play next.
+//
+// The search runs on its own thread and deepens one turn at a time, so the
+// hint starts as the greedy pick and refines while the player thinks.  Each
+// finished depth is published to a single atomic slot tagged with the
+// position it belongs to.  The render thread only ever loads that slot, it
+// never waits on the search.
+//
+//	hint.Start(SnapshotGame());  // when the player can pick a card
+//	hint.Cancel();               // when the position is about to change
+//	int card = hint.Card();      // every frame, index into hand.cards or -1
+
+#include "Game.h"
+#include "Planner.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// The position on screen as a sim::Game.  The deck keeps its real order but
+// the planner only ever samples it reshuffled.
+inline sim::Game SnapshotGame() {
+	sim::Game game;
+	game.game_length = game_length;
+	game.deck_size = std::min<int>(the_deck.size(), sim::max_deck_size);
+	for (int i = 0; i < game.deck_size; i++) {
+		game.deck[i] = ToSim(the_deck.cards[i]);
+	}
+	game.hand_size = std::min<int>(hand.cards.size(), sim::hand_limit);
+	for (int i = 0; i < game.hand_size; i++) {
+		game.hand[i] = ToSim(hand.cards[i]);
+	}
+	game.in_play_size = std::min<int>(in_play.cards.size(), sim::max_deck_size);
+	for (int i = 0; i < game.in_play_size; i++) {
+		game.in_play[i] = ToSim(in_play.cards[i]);
+	}
+	game.last_locked = game.in_play_size > 0 && in_play.cards.back().locked;
+	for (const auto& [key, rule] : enabled_rules) {
+		sim::RuleBit bit = sim::RuleIndex(key);
+		if (bit < sim::RULE_COUNT) {
+			game.rules |= sim::Bit(bit);
+			game.rule_values[bit] = int8_t(rule.value);
+		}
+	}
+	game.score = score;
+	game.key = game.ComputeKey();
+	return game;
+}
+
+class HintSearch {
+public:
+	// Read by the search thread, only change before the first Start
+	planner::Options options;
+
+	HintSearch() {
+		// Deepen until cancelled rather than stopping at a budget
+		options.max_depth = 6;
+		options.budget_ms = 60000.0;
+		options.cancel = &cancel;
+	}
+
+	~HintSearch() {
+		if (worker.joinable()) {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				quit = true;
+				cancel = true;
+			}
+			wake.notify_one();
+			worker.join();
+		}
+	}
+
+	// Drops the current search and starts one on game.  The lock is only held
+	// by the search thread while it takes the request, never while searching.
+	void Start(const sim::Game& game) {
+		generation++;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			request = game;
+			request_generation = generation;
+			pending = true;
+			cancel = true;
+		}
+		wake.notify_one();
+		if (!worker.joinable()) {
+			worker = std::thread(&HintSearch::Search, this);
+		}
+	}
+
+	// Stops the search and hides the hint until the next Start
+	void Cancel() {
+		generation++;
+		std::lock_guard<std::mutex> lock(mutex);
+		pending = false;
+		cancel = true;
+	}
+
+	// Index of the hinted card in the hand, or -1 while there is nothing to
+	// show for the current position
+	int Card() const {
+		uint64_t result = slot.load(std::memory_order_acquire);
+		if (uint32_t(result >> 32) != generation) {
+			return -1;
+		}
+		int action = int(result & 0xFF);
+		return action >= sim::PLAY_0 && action < sim::PLAY_0 + sim::hand_limit ? action - sim::PLAY_0 : -1;
+	}
+
+	// Deepest search behind the current hint, 0 for the greedy pick
+	int Depth() const {
+		uint64_t result = slot.load(std::memory_order_acquire);
+		return uint32_t(result >> 32) == generation ? int((result >> 8) & 0xFF) : -1;
+	}
+
+private:
+	// Only touched by the render thread
+	uint32_t generation = 0;
+
+	std::thread worker;
+	std::mutex mutex;
+	std::condition_variable wake;
+	sim::Game request;
+	uint32_t request_generation = 0;
+	bool pending = false;
+	bool quit = false;
+
+	std::atomic<bool> cancel{ false };
+	std::atomic<uint64_t> slot{ ~0ull }; // generation << 32 | depth << 8 | action
+
+	void Publish(uint32_t for_generation, int depth, int action) {
+		slot.store(uint64_t(for_generation) << 32 | uint64_t(depth & 0xFF) << 8 | uint64_t(action & 0xFF), std::memory_order_release);
+	}
+
+	void Search() {
+		TranspositionTable table(16 << 20);
+		sim::Game game;
+		while (true) {
+			uint32_t searching;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				wake.wait(lock, [this] { return pending || quit; });
+				if (quit) {
+					return;
+				}
+				game = request;
+				searching = request_generation;
+				pending = false;
+				cancel = false;
+			}
+
+			Publish(searching, 0, search::GreedyAction(game, table));
+			for (int depth = 1; depth <= options.max_depth; depth++) {
+				planner::Options deeper = options;
+				deeper.max_depth = depth;
+				planner::Plan plan = planner::Choose(game, deeper, table, searching);
+				if (plan.depth < depth) {
+					break;
+				}
+				Publish(searching, depth, plan.action);
+			}
+		}
+	}
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+// Which rect on screen a click landed on, without scanning every rect.
+//
+// Buttons and cards are added once whenever the layout changes.  The screen is
+// split into square cells and each cell lists the rects overlapping it, so a
+// point only tests the few rects in its own cell however many are registered.
+//
+//	grid.Clear();
+//	grid.Add(HIT_DISCARD, button_pos, button_size);  // when the layout changes
+//	...
+//	int id = grid.Pressed(pge);                      // every frame, -1 for none
+//
+// Rects added later are on top of earlier ones where they overlap.  Clear
+// keeps the storage, so rebuilding a layout of the same size or smaller does
+// not allocate.
+
+#include "olcPixelGameEngine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+class HitGrid {
+public:
+	// Cells of cell_size pixels covering a width by height screen, points
+	// outside it hit nothing
+	explicit HitGrid(int width = 256, int height = 240, int cell_size = 16)
+		: cell_size(cell_size), columns((width + cell_size - 1) / cell_size), rows((height + cell_size - 1) / cell_size) {
+		cell_start.resize(size_t(columns) * rows + 1);
+	}
+
+	void Clear() {
+		targets.clear();
+		dirty = true;
+	}
+
+	void Add(int id, const olc::vf2d& pos, const olc::vf2d& size) {
+		targets.push_back({ id, pos, size });
+		dirty = true;
+	}
+
+	size_t Size() const {
+		return targets.size();
+	}
+
+	// Id of the topmost rect containing point, or -1
+	int At(const olc::vf2d& point) {
+		if (dirty) {
+			Build();
+		}
+		if (point.x < 0.0f || point.y < 0.0f) {
+			return -1;
+		}
+		int column = int(point.x) / cell_size;
+		int row = int(point.y) / cell_size;
+		if (column >= columns || row >= rows) {
+			return -1;
+		}
+		int cell = row * columns + column;
+		for (int i = cell_start[cell + 1] - 1; i >= cell_start[cell]; i--) {
+			const Target& t = targets[cell_targets[i]];
+			if (point.x >= t.pos.x && point.y >= t.pos.y && point.x < t.pos.x + t.size.x && point.y < t.pos.y + t.size.y) {
+				return t.id;
+			}
+		}
+		return -1;
+	}
+
+	// Id under the mouse on the frame the left button goes down, otherwise -1
+	int Pressed(olc::PixelGameEngine* pge) {
+		return pge->GetMouse(0).bPressed ? At(pge->GetMousePos()) : -1;
+	}
+
+private:
+	struct Target {
+		int id;
+		olc::vf2d pos;
+		olc::vf2d size;
+	};
+
+	int cell_size;
+	int columns;
+	int rows;
+	bool dirty = true;
+	std::vector<Target> targets;
+	// The targets overlapping cell c are cell_targets[cell_start[c]] up to
+	// cell_targets[cell_start[c + 1]], in the order they were added
+	std::vector<int> cell_start;
+	std::vector<int> cell_targets;
+	std::vector<int> cell_fill;
+
+	// Cells overlapped by the target, false if it is off the screen
+	bool Cells(const Target& t, int& x0, int& y0, int& x1, int& y1) const {
+		if (t.size.x <= 0.0f || t.size.y <= 0.0f) {
+			return false;
+		}
+		x0 = std::max(0, int(std::floor(t.pos.x)) / cell_size);
+		y0 = std::max(0, int(std::floor(t.pos.y)) / cell_size);
+		x1 = std::min(columns - 1, int(std::floor(t.pos.x + t.size.x)) / cell_size);
+		y1 = std::min(rows - 1, int(std::floor(t.pos.y + t.size.y)) / cell_size);
+		return t.pos.x + t.size.x > 0.0f && t.pos.y + t.size.y > 0.0f && x0 <= x1 && y0 <= y1;
+	}
+
+	// Counts the targets in each cell, then places them, keeping their order
+	void Build() {
+		std::fill(cell_start.begin(), cell_start.end(), 0);
+		int x0, y0, x1, y1;
+		for (const Target& t : targets) {
+			if (Cells(t, x0, y0, x1, y1)) {
+				for (int y = y0; y <= y1; y++) {
+					for (int x = x0; x <= x1; x++) {
+						cell_start[y * columns + x + 1]++;
+					}
+				}
+			}
+		}
+		for (size_t c = 1; c < cell_start.size(); c++) {
+			cell_start[c] += cell_start[c - 1];
+		}
+
+		cell_targets.resize(cell_start.back());
+		cell_fill.assign(cell_start.begin(), cell_start.end() - 1);
+		for (int i = 0; i < int(targets.size()); i++) {
+			if (Cells(targets[i], x0, y0, x1, y1)) {
+				for (int y = y0; y <= y1; y++) {
+					for (int x = x0; x <= x1; x++) {
+						cell_targets[cell_fill[y * columns + x]++] = i;
+					}
+				}
+			}
+		}
+		dirty = false;
+	}
+};
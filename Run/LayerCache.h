@@ -0,0 +1,137 @@
+#pragma once
+
+// Static screens drawn once and shown from a single quad.
+//
+// A screen that does not change between frames is drawn through its usual
+// decal calls once, those decals are rasterised on the CPU, and from then on
+// the screen costs one quad a frame.  Anything that does change is drawn with
+// decals as before and lands on top.
+//
+// The decals are rasterised at the window's resolution, not the 256x240
+// screen's, so sub-pixel card positions, scaled text and polygon edges land
+// on the same monitor pixels as when the GPU draws them.  A window showing
+// the screen at 1:1 is baked into layer 0, which the engine draws anyway.  A
+// scaled window is baked into a decal of the window's size, drawn with one
+// texel to each monitor pixel.
+//
+//	screen_cache.Draw(pge, this, page, [&] { DrawStaticParts(); });
+//	DrawDynamicParts();
+//
+// A screen is drawn again when its owner or page changes, when the window's
+// scale changes, when the layer is recreated or after Invalidate.  Screens
+// that stop using the cache are cleared away by EndFrame.
+
+#include "olcPixelGameEngine.h"
+#include "SoftwareRenderer.h"
+
+#include <algorithm>
+#include <memory>
+
+class LayerCache {
+public:
+	// Set for a frame when something is drawn beneath the screen, which then
+	// has to be drawn over it with decals
+	bool immediate = false;
+
+	template <typename F>
+	void Draw(olc::PixelGameEngine* pge, const void* owner, int page, F&& draw) {
+		used = true;
+		if (immediate) {
+			Clear(pge);
+			draw();
+			return;
+		}
+
+		// Whole monitor pixels per screen pixel, 1 when the window is no
+		// bigger than the screen
+		olc::vi2d scale = {
+			std::max(1, pge->GetWindowSize().x / pge->GetScreenSize().x),
+			std::max(1, pge->GetWindowSize().y / pge->GetScreenSize().y),
+		};
+		olc::vi2d size = pge->GetScreenSize() * scale;
+		bool in_layer = scale == olc::vi2d{ 1, 1 };
+		if (!in_layer && (sprite == nullptr || sprite->width != size.x || sprite->height != size.y)) {
+			sprite = std::make_unique<olc::Sprite>(size.x, size.y);
+			decal = std::make_unique<olc::Decal>(sprite.get());
+		}
+
+		olc::Sprite* target = in_layer ? pge->GetLayers()[0].pDrawTarget.Sprite() : sprite.get();
+		if (baked_sprite != target || baked_owner != owner || baked_page != page || baked_scale != scale) {
+			Clear(pge);
+			Bake(pge, target, draw);
+			if (!in_layer) {
+				decal->Update();
+			}
+			baked_sprite = target;
+			baked_owner = owner;
+			baked_page = page;
+			baked_scale = scale;
+		}
+		if (!in_layer) {
+			pge->DrawDecal({ 0.0f, 0.0f }, decal.get(), { 1.0f / scale.x, 1.0f / scale.y });
+		}
+	}
+
+	// Draws the current screen again next frame
+	void Invalidate() {
+		baked_owner = nullptr;
+	}
+
+	// Call once a frame after the game states have drawn
+	void EndFrame(olc::PixelGameEngine* pge) {
+		if (!used) {
+			Clear(pge);
+		}
+		used = false;
+	}
+
+private:
+	// The window sized bake, kept for the next screen
+	std::unique_ptr<olc::Sprite> sprite;
+	std::unique_ptr<olc::Decal> decal;
+	const olc::Sprite* baked_sprite = nullptr;
+	const void* baked_owner = nullptr;
+	int baked_page = 0;
+	olc::vi2d baked_scale = { 0, 0 };
+	bool used = false;
+
+	// Only the screen's own decals are taken off the layer and rasterised.
+	// Their positions are in device coordinates, so any target size works.
+	template <typename F>
+	void Bake(olc::PixelGameEngine* pge, olc::Sprite* target, F&& draw) {
+		olc::LayerDesc& layer = pge->GetLayers()[0];
+		pge->SetDrawTarget(nullptr);
+		size_t first = layer.vecDecalInstance.size();
+		draw();
+
+		std::fill(target->GetData(), target->GetData() + size_t(target->width) * target->height, olc::BLACK);
+		for (size_t i = first; i < layer.vecDecalInstance.size(); i++) {
+			const olc::DecalInstance& decal = layer.vecDecalInstance[i];
+			olc::Renderer_Software::TextureView view;
+			if (decal.decal != nullptr && decal.decal->sprite != nullptr) {
+				view = { uint32_t(decal.decal->sprite->width), uint32_t(decal.decal->sprite->height), decal.decal->sprite->GetData() };
+			}
+			olc::Renderer_Software::RasteriseDecal(decal, view.pixels != nullptr ? &view : nullptr, target->GetData(), { target->width, target->height });
+		}
+		// Handed back to the pool the engine reuses instances from
+		for (size_t i = first; i < layer.vecDecalInstance.size(); i++) {
+			layer.vecDecalPool.push_back(std::move(layer.vecDecalInstance[i]));
+		}
+		layer.vecDecalInstance.resize(first);
+	}
+
+	// Blanks layer 0 if the screen was baked into it
+	void Clear(olc::PixelGameEngine* pge) {
+		if (baked_sprite == nullptr) {
+			return;
+		}
+		olc::Sprite* target = pge->GetLayers()[0].pDrawTarget.Sprite();
+		if (target == baked_sprite) {
+			std::fill(target->GetData(), target->GetData() + size_t(target->width) * target->height, olc::BLACK);
+		}
+		baked_sprite = nullptr;
+		baked_owner = nullptr;
+	}
+};
+
+inline LayerCache screen_cache;
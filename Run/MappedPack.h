@@ -0,0 +1,405 @@
+#pragma once
+
+// A memory mapped alternative to olc::ResourcePack.
+//
+// olc::ResourcePack reads its index a byte at a time and copies every file
+// it serves into a std::streambuf.  A MappedPack maps the whole pack and
+// hands out views straight into the mapping, finds files through a hash
+// table stored in the pack, and only touches the pages of the files that are
+// actually asked for.  With a key the files are XOR scrambled against a 16
+// byte pad; a file is unscrambled in place (in copy-on-write pages) the first
+// time it is asked for.
+//
+//	olc::MappedPack::SavePack("assets.pack", { "cards/back.png", "font.png" }, "key");
+//
+//	olc::MappedPack pack;
+//	pack.Open("assets.pack", "key");
+//	olc::PackView png = pack.Get("cards/back.png");
+//	olc::PackViewBuffer buffer(png); // for decoders that want a std::istream
+//
+// Layout, little endian:
+//	Header                                     magic, counts, key check
+//	uint32_t buckets[nBuckets]                 entry index + 1, 0 when empty, linear probing
+//	Entry entries[nEntries]                    path hash, data offset and size, name
+//	char names[nNamesSize]                     scrambled
+//	file data                                  each file 16 byte aligned, scrambled
+//
+// Views stay valid until the pack is closed.  Get may be called from several
+// threads at once.
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OLC_MAPPEDPACK_SSE2
+#endif
+
+namespace olc
+{
+	// One file in a pack, read only and valid while the pack is open
+	struct PackView
+	{
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+
+		bool empty() const { return size == 0; }
+		const uint8_t* begin() const { return data; }
+		const uint8_t* end() const { return data + size; }
+	};
+
+	// Lets stream based decoders read a view without copying it
+	struct PackViewBuffer : public std::streambuf
+	{
+		explicit PackViewBuffer(PackView view)
+		{
+			char* p = reinterpret_cast<char*>(const_cast<uint8_t*>(view.data));
+			setg(p, p, p + view.size);
+		}
+	};
+
+	class MappedPack
+	{
+	public:
+		using Pad = std::array<uint8_t, 16>;
+
+		MappedPack() = default;
+		MappedPack(const MappedPack&) = delete;
+		MappedPack& operator=(const MappedPack&) = delete;
+		~MappedPack() { Close(); }
+
+		bool Open(const std::string& sFile, const std::string& sKey = "")
+		{
+			Close();
+			if (!Map(sFile)) return false;
+
+			if (nMapSize < sizeof(Header)) return Fail();
+			std::memcpy(&header, pMap, sizeof(Header));
+			if (std::memcmp(header.magic, "RUNPACK", 8) != 0 || header.nVersion != 2) return Fail();
+			if (header.nBuckets == 0 || (header.nBuckets & (header.nBuckets - 1)) != 0) return Fail();
+			if (header.nKeyCheck != KeyCheck(sKey)) return Fail();
+
+			size_t nEntriesOffset = sizeof(Header) + size_t(header.nBuckets) * sizeof(uint32_t);
+			if (nEntriesOffset + size_t(header.nEntries) * sizeof(Entry) > header.nNamesOffset) return Fail();
+			if (header.nNamesOffset + header.nNamesSize > nMapSize) return Fail();
+
+			pBuckets = reinterpret_cast<const uint32_t*>(pMap + sizeof(Header));
+			pEntries = reinterpret_cast<const Entry*>(pMap + nEntriesOffset);
+			pNames = reinterpret_cast<const char*>(pMap + header.nNamesOffset);
+			// Probing stops at an empty bucket, so a full table would never end
+			bool bEmptyBucket = false;
+			for (uint32_t b = 0; b < header.nBuckets; b++)
+			{
+				if (pBuckets[b] > header.nEntries) return Fail();
+				bEmptyBucket |= pBuckets[b] == 0;
+			}
+			if (!bEmptyBucket) return Fail();
+			for (uint32_t i = 0; i < header.nEntries; i++)
+			{
+				const Entry& e = pEntries[i];
+				if (e.nOffset + e.nSize > nMapSize || e.nOffset % 16 != 0) return Fail();
+				if (size_t(e.nNameOffset) + e.nNameSize > header.nNamesSize) return Fail();
+			}
+
+			pad = MakePad(sKey);
+			bScrambled = !sKey.empty();
+			if (bScrambled)
+			{
+				Scramble(pMap + header.nNamesOffset, header.nNamesSize, pad);
+				pReady.reset(new std::once_flag[header.nEntries]);
+			}
+			return true;
+		}
+
+		void Close()
+		{
+			if (pMap != nullptr)
+			{
+#if defined(_WIN32)
+				UnmapViewOfFile(pMap);
+#else
+				munmap(pMap, nMapSize);
+#endif
+			}
+			pMap = nullptr;
+			nMapSize = 0;
+			header = {};
+			pReady.reset();
+		}
+
+		bool Loaded() const { return pMap != nullptr; }
+		size_t Count() const { return header.nEntries; }
+
+		std::string_view Name(size_t i) const
+		{
+			return { pNames + pEntries[i].nNameOffset, pEntries[i].nNameSize };
+		}
+
+		// The file at sFile, with either slash as the separator, or an empty view
+		PackView Get(std::string_view sFile)
+		{
+			if (pMap == nullptr) return {};
+			uint64_t nHash = Hash(sFile);
+			uint32_t nMask = header.nBuckets - 1;
+			for (uint32_t b = uint32_t(nHash) & nMask; pBuckets[b] != 0; b = (b + 1) & nMask)
+			{
+				uint32_t i = pBuckets[b] - 1;
+				if (pEntries[i].nHash == nHash && SamePath(Name(i), sFile)) return View(i);
+			}
+			return {};
+		}
+
+		PackView Get(size_t i)
+		{
+			return i < header.nEntries ? View(uint32_t(i)) : PackView{};
+		}
+
+		// Packs the files, named as given with backslashes turned into slashes
+		static bool SavePack(const std::string& sFile, const std::vector<std::string>& vFiles, const std::string& sKey = "")
+		{
+			Header h;
+			std::memcpy(h.magic, "RUNPACK", 8);
+			h.nEntries = uint32_t(vFiles.size());
+			h.nBuckets = 2;
+			while (h.nBuckets < h.nEntries * 2) h.nBuckets *= 2;
+			h.nKeyCheck = KeyCheck(sKey);
+
+			std::vector<uint32_t> buckets(h.nBuckets, 0);
+			std::vector<Entry> entries(h.nEntries);
+			std::string names;
+			std::vector<std::vector<uint8_t>> data(h.nEntries);
+
+			for (uint32_t i = 0; i < h.nEntries; i++)
+			{
+				std::string name = vFiles[i];
+				for (auto& c : name) c = c == '\\' ? '/' : c;
+
+				std::ifstream ifs(vFiles[i], std::ifstream::binary);
+				if (!ifs.is_open()) return false;
+				data[i].assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+
+				Entry& e = entries[i];
+				e.nHash = Hash(name);
+				e.nSize = data[i].size();
+				e.nNameOffset = uint32_t(names.size());
+				e.nNameSize = uint32_t(name.size());
+				names += name;
+
+				uint32_t b = uint32_t(e.nHash) & (h.nBuckets - 1);
+				while (buckets[b] != 0) b = (b + 1) & (h.nBuckets - 1);
+				buckets[b] = i + 1;
+			}
+
+			h.nNamesOffset = sizeof(Header) + buckets.size() * sizeof(uint32_t) + entries.size() * sizeof(Entry);
+			h.nNamesSize = names.size();
+			uint64_t nOffset = Align(h.nNamesOffset + h.nNamesSize);
+			for (uint32_t i = 0; i < h.nEntries; i++)
+			{
+				entries[i].nOffset = nOffset;
+				nOffset = Align(nOffset + entries[i].nSize);
+			}
+
+			const Pad p = MakePad(sKey);
+			if (!sKey.empty())
+			{
+				Scramble(reinterpret_cast<uint8_t*>(names.data()), names.size(), p);
+				for (auto& d : data) Scramble(d.data(), d.size(), p);
+			}
+
+			std::ofstream ofs(sFile, std::ofstream::binary);
+			if (!ofs.is_open()) return false;
+			ofs.write(reinterpret_cast<const char*>(&h), sizeof(Header));
+			ofs.write(reinterpret_cast<const char*>(buckets.data()), buckets.size() * sizeof(uint32_t));
+			ofs.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+			ofs.write(names.data(), names.size());
+			const char zeros[16] = {};
+			uint64_t nWritten = h.nNamesOffset + h.nNamesSize;
+			for (uint32_t i = 0; i < h.nEntries; i++)
+			{
+				ofs.write(zeros, entries[i].nOffset - nWritten);
+				ofs.write(reinterpret_cast<const char*>(data[i].data()), data[i].size());
+				nWritten = entries[i].nOffset + entries[i].nSize;
+			}
+			return bool(ofs);
+		}
+
+		// XORs data with the pad repeated, data[i] with pad[i % 16]
+		static void Scramble(uint8_t* data, size_t size, const Pad& p)
+		{
+			size_t i = 0;
+#if defined(OLC_MAPPEDPACK_SSE2)
+			const __m128i vPad = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p.data()));
+			for (; i + 64 <= size; i += 64)
+			{
+				__m128i* q = reinterpret_cast<__m128i*>(data + i);
+				_mm_storeu_si128(q + 0, _mm_xor_si128(_mm_loadu_si128(q + 0), vPad));
+				_mm_storeu_si128(q + 1, _mm_xor_si128(_mm_loadu_si128(q + 1), vPad));
+				_mm_storeu_si128(q + 2, _mm_xor_si128(_mm_loadu_si128(q + 2), vPad));
+				_mm_storeu_si128(q + 3, _mm_xor_si128(_mm_loadu_si128(q + 3), vPad));
+			}
+			for (; i + 16 <= size; i += 16)
+			{
+				__m128i* q = reinterpret_cast<__m128i*>(data + i);
+				_mm_storeu_si128(q, _mm_xor_si128(_mm_loadu_si128(q), vPad));
+			}
+#else
+			uint64_t nPad[2];
+			std::memcpy(nPad, p.data(), 16);
+			for (; i + 16 <= size; i += 16)
+			{
+				uint64_t w[2];
+				std::memcpy(w, data + i, 16);
+				w[0] ^= nPad[0];
+				w[1] ^= nPad[1];
+				std::memcpy(data + i, w, 16);
+			}
+#endif
+			for (; i < size; i++) data[i] ^= p[i & 15];
+		}
+
+		// FNV-1a of the path with backslashes read as slashes
+		static uint64_t Hash(std::string_view path)
+		{
+			uint64_t h = 0xCBF29CE484222325ull;
+			for (char c : path)
+			{
+				h ^= uint8_t(c == '\\' ? '/' : c);
+				h *= 0x100000001B3ull;
+			}
+			return h;
+		}
+
+	private:
+		struct Header
+		{
+			char magic[8] = {};
+			uint32_t nVersion = 2;
+			uint32_t nEntries = 0;
+			uint32_t nBuckets = 0;
+			uint32_t nFlags = 0; // none yet
+			uint64_t nKeyCheck = 0;
+			uint64_t nNamesOffset = 0;
+			uint64_t nNamesSize = 0;
+		};
+
+		struct Entry
+		{
+			uint64_t nHash;
+			uint64_t nOffset;
+			uint64_t nSize;
+			uint32_t nNameOffset;
+			uint32_t nNameSize;
+		};
+
+		static_assert(sizeof(Header) == 48 && sizeof(Entry) == 32, "pack layout is written as is");
+
+		uint8_t* pMap = nullptr;
+		size_t nMapSize = 0;
+		Header header;
+		const uint32_t* pBuckets = nullptr;
+		const Entry* pEntries = nullptr;
+		const char* pNames = nullptr;
+		Pad pad = {};
+		bool bScrambled = false;
+		std::unique_ptr<std::once_flag[]> pReady;
+
+		PackView View(uint32_t i)
+		{
+			const Entry& e = pEntries[i];
+			uint8_t* data = pMap + e.nOffset;
+			if (bScrambled) std::call_once(pReady[i], [&] { Scramble(data, size_t(e.nSize), pad); });
+			return { data, size_t(e.nSize) };
+		}
+
+		bool Map(const std::string& sFile)
+		{
+#if defined(_WIN32)
+			HANDLE hFile = CreateFileA(sFile.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (hFile == INVALID_HANDLE_VALUE) return false;
+			LARGE_INTEGER size;
+			HANDLE hMapping = nullptr;
+			if (GetFileSizeEx(hFile, &size) && size.QuadPart > 0)
+				hMapping = CreateFileMappingA(hFile, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+			CloseHandle(hFile);
+			if (hMapping == nullptr) return false;
+			// Copy on write, so unscrambling never reaches the file
+			pMap = static_cast<uint8_t*>(MapViewOfFile(hMapping, FILE_MAP_COPY, 0, 0, 0));
+			CloseHandle(hMapping);
+			nMapSize = pMap != nullptr ? size_t(size.QuadPart) : 0;
+#else
+			int fd = open(sFile.c_str(), O_RDONLY);
+			if (fd < 0) return false;
+			struct stat st;
+			void* p = MAP_FAILED;
+			if (fstat(fd, &st) == 0 && st.st_size > 0)
+				p = mmap(nullptr, size_t(st.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+			close(fd);
+			if (p == MAP_FAILED) return false;
+			pMap = static_cast<uint8_t*>(p);
+			nMapSize = size_t(st.st_size);
+#endif
+			return pMap != nullptr;
+		}
+
+		bool Fail()
+		{
+			Close();
+			return false;
+		}
+
+		static bool SamePath(std::string_view stored, std::string_view query)
+		{
+			if (stored.size() != query.size()) return false;
+			for (size_t i = 0; i < query.size(); i++)
+				if (stored[i] != (query[i] == '\\' ? '/' : query[i])) return false;
+			return true;
+		}
+
+		static uint64_t Align(uint64_t n) { return (n + 15) & ~uint64_t(15); }
+
+		static uint64_t Mix(uint64_t x)
+		{
+			x += 0x9E3779B97F4A7C15ull;
+			x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+			x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+			return x ^ (x >> 31);
+		}
+
+		static Pad MakePad(const std::string& sKey)
+		{
+			Pad p = {};
+			if (sKey.empty()) return p;
+			uint64_t a = Mix(Hash(sKey));
+			uint64_t b = Mix(a);
+			std::memcpy(p.data(), &a, 8);
+			std::memcpy(p.data() + 8, &b, 8);
+			return p;
+		}
+
+		// Lets Open tell a wrong key from a damaged pack.  Hashed with a salt
+		// of its own rather than taken further along the pad's Mix chain, since
+		// Mix can be undone and the check would give the pad away.
+		static uint64_t KeyCheck(const std::string& sKey)
+		{
+			if (sKey.empty()) return 0;
+			return Mix(Hash("RUNPACK key check:" + sKey));
+		}
+	};
+}
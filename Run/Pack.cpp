@@ -0,0 +1,78 @@
+// Builds and inspects asset packs for olc::MappedPack, see MappedPack.h.
+//
+// Build (from the repository root):
+//	g++ -std=c++17 -O2 Run/Pack.cpp -o pack
+//	cl /std:c++17 /O2 /EHsc Run\Pack.cpp
+//
+// Usage:
+//	pack <out.pack> [--key K] <file>...
+//	pack --list <pack> [--key K]
+//
+// Files are stored under the paths given on the command line.  Listing
+// prints every file with its size and checks it can be read back.
+
+#include "MappedPack.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+	std::string pack_path;
+	std::string key;
+	bool list = false;
+	std::vector<std::string> files;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--key" && i + 1 < argc) {
+			key = argv[++i];
+		}
+		else if (arg == "--list" && i + 1 < argc) {
+			list = true;
+			pack_path = argv[++i];
+		}
+		else if (arg[0] != '-' && pack_path.empty()) {
+			pack_path = arg;
+		}
+		else if (arg[0] != '-') {
+			files.push_back(arg);
+		}
+		else {
+			pack_path.clear();
+			break;
+		}
+	}
+	if (pack_path.empty() || (!list && files.empty())) {
+		std::printf("usage: %s <out.pack> [--key K] <file>...\n"
+			"       %s --list <pack> [--key K]\n", argv[0], argv[0]);
+		return 2;
+	}
+
+	if (!list) {
+		if (!olc::MappedPack::SavePack(pack_path, files, key)) {
+			std::printf("Could not write %s\n", pack_path.c_str());
+			return 1;
+		}
+		std::printf("Packed %zu files into %s\n", files.size(), pack_path.c_str());
+		return 0;
+	}
+
+	olc::MappedPack pack;
+	if (!pack.Open(pack_path, key)) {
+		std::printf("Could not open %s, is the key right?\n", pack_path.c_str());
+		return 1;
+	}
+	int missing = 0;
+	for (size_t i = 0; i < pack.Count(); i++) {
+		std::string_view name = pack.Name(i);
+		olc::PackView view = pack.Get(name);
+		missing += view.data != pack.Get(i).data;
+		std::printf("%10zu %.*s\n", view.size, int(name.size()), name.data());
+	}
+	if (missing > 0) {
+		std::printf("%d files could not be found by name\n", missing);
+		return 1;
+	}
+	return 0;
+}
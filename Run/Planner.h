@@ -0,0 +1,204 @@
+#pragma once
+
+// A depth limited expectimax player over whole turns.
+//
+// A turn is a choice of which cards from the hand to play as a run (or to
+// discard the hand).  After it comes a chance node: the rule roll at the end
+// of the turn and the cards drawn to refill the hand.  The player knows which
+// cards are left in the deck, as a card counting human could, but never
+// their order:
+//
+//	- the points for a turn are the exact expectation over the rule roll,
+//	  which can change how the run itself is scored
+//	- draws are sampled from the deck reshuffled, so every sample is a draw
+//	  with its true probability, and the rule roll is sampled with them
+//	- after a few samples a turn whose optimistic estimate cannot catch the
+//	  best one found so far is dropped
+//
+// Depth counts turns.  Search deepens one turn at a time until the time
+// budget runs out and answers with the deepest search that finished.  A node
+// budget can stop it instead, which gives the same answer on any machine
+// under any load.
+//
+//	planner::Options options; // depth 3, 50ms
+//	planner::Plan plan = planner::Choose(game, options, table, seed);
+//	game.Step(plan.action);
+
+#include "Search.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+namespace planner {
+	constexpr uint64_t value_salt = 0x2C1B3C6D5E7F8091ull;
+
+	struct Options {
+		int max_depth = 3;
+		int samples = 6;        // draws sampled per turn at the top, halved each level down
+		int max_turns = 6;      // candidate turns kept for the decision, best immediate points first
+		int inner_turns = 3;    // the same for the turns after it
+		double budget_ms = 50.0;
+		uint64_t max_nodes = 0;  // also ends the search once this many nodes are searched, 0 for no limit
+		float card_value = 2.7f; // points a card still in the deck is worth, about what GreedyAction averages
+		const std::atomic<bool>* cancel = nullptr; // ends the search like the budget running out once set
+	};
+
+	struct Plan {
+		int action = sim::DISCARD;
+		float value = 0.0f;     // expected points over the turns searched
+		int depth = 0;          // deepest search that finished
+		uint64_t nodes = 0;
+	};
+
+	namespace detail {
+		// Expected score of a run over the rule that may be rolled before it is scored
+		inline float ExpectedScore(const sim::ScoreCounter& counter, uint32_t rules) {
+			if (counter.length < 3) {
+				return 0.0f;
+			}
+			int enabled = 0;
+			for (int r = 0; r < int(sim::RULE_COUNT); r++) {
+				enabled += (rules >> r) & 1;
+			}
+			float p_roll = 2.0f / float(6 + enabled);
+
+			float rolled = 0.0f;
+			for (int r = 0; r < int(sim::RULE_COUNT); r++) {
+				rolled += float(counter.Total(rules | (1u << r)));
+			}
+			return (1.0f - p_roll) * float(counter.Total(rules)) + p_roll * rolled / float(sim::RULE_COUNT);
+		}
+
+		struct Context {
+			const Options& options;
+			TranspositionTable& table;
+			std::chrono::steady_clock::time_point deadline;
+			uint64_t nodes = 0;
+			bool out_of_time = false;
+
+			bool TimeUp() {
+				if (!out_of_time) {
+					out_of_time = std::chrono::steady_clock::now() >= deadline
+					|| (options.max_nodes && nodes >= options.max_nodes)
+					|| (options.cancel && options.cancel->load(std::memory_order_relaxed));
+				}
+				return out_of_time;
+			}
+		};
+
+		float Value(const sim::Game& game, int depth, int samples, uint32_t seed, Context& ctx, int* best_action);
+
+		// Expected points of taking turn and then searching depth - 1 more.  The
+		// last turn searched is valued by the best run the next hand holds plus
+		// what the cards still in the deck are worth.
+		inline float TurnValue(const sim::Game& game, const search::Turn& turn, int depth, int samples, uint32_t seed, float to_beat, Context& ctx) {
+			float total = 0.0f;
+			float total_sq = 0.0f;
+			sim::Game child;
+			for (int s = 0; s < samples; s++) {
+				child = game;
+				child.rng.seed(seed + s);
+				std::shuffle(child.deck.begin(), child.deck.begin() + child.deck_size, child.rng);
+				search::ApplyTurn(child, turn);
+
+				float v = 0.0f;
+				if (!child.over && depth > 1) {
+					v = Value(child, depth - 1, std::max(2, samples / 2), seed * 31 + s, ctx, nullptr);
+				}
+				else if (!child.over) {
+					ctx.nodes++;
+					v = float(std::max(0, search::BestRun(child, ctx.table).score)) + ctx.options.card_value * float(child.deck_size);
+				}
+				if (ctx.TimeUp()) {
+					return 0.0f;
+				}
+				total += v;
+				total_sq += v * v;
+
+				// Drop the turn once even an optimistic estimate falls short
+				int n = s + 1;
+				if (n >= 3 && n < samples) {
+					float mean = total / n;
+					float spread = std::sqrt(std::max(0.0f, total_sq / n - mean * mean) / n);
+					if (turn.points + mean + 3.0f * spread + 1.0f < to_beat) {
+						return turn.points + mean;
+					}
+				}
+			}
+			return turn.points + total / float(samples);
+		}
+
+		// Best expected points over the next depth turns
+		inline float Value(const sim::Game& game, int depth, int samples, uint32_t seed, Context& ctx, int* best_action) {
+			ctx.nodes++;
+			uint64_t key = game.key ^ value_salt ^ sim::zobrist::SplitMix(uint64_t(game.deck_size) << 8 | uint64_t(depth));
+			TranspositionTable::Entry entry;
+			if (best_action == nullptr && ctx.table.Probe(key, entry) && entry.depth >= depth) {
+				return entry.value;
+			}
+			if (ctx.TimeUp()) {
+				return 0.0f;
+			}
+
+			search::Turns turns;
+			int count = search::EnumerateTurns(game, turns);
+			for (int t = 0; t < count; t++) {
+				turns[t].points = ExpectedScore(search::TurnCounter(game, turns[t]), game.rules);
+			}
+
+			// Best immediate points first, keep the discard as a fallback
+			search::Turn discard = turns[count - 1];
+			std::sort(turns.begin(), turns.begin() + count - 1, [](const search::Turn& a, const search::Turn& b) { return a.points > b.points; });
+			int kept = std::min(count - 1, best_action ? ctx.options.max_turns : ctx.options.inner_turns);
+			turns[kept] = discard;
+			count = kept + 1;
+
+			float best = -1.0f;
+			int best_turn = count - 1;
+			for (int t = 0; t < count; t++) {
+				float v = TurnValue(game, turns[t], depth, samples, seed, best, ctx);
+				if (ctx.out_of_time) {
+					return 0.0f;
+				}
+				if (v > best) {
+					best = v;
+					best_turn = t;
+				}
+			}
+
+			if (best_action) {
+				*best_action = search::TurnAction(turns[best_turn]);
+			}
+			ctx.table.Store(key, { best, uint8_t(depth), TranspositionTable::EXACT, 0 });
+			return best;
+		}
+	}
+
+	// Picks the next action for game without looking at the deck order
+	inline Plan Choose(const sim::Game& game, const Options& options, TranspositionTable& table, uint32_t seed) {
+		Plan plan;
+		if (game.over) {
+			return plan;
+		}
+
+		detail::Context ctx{ options, table, std::chrono::steady_clock::now() + std::chrono::microseconds(int64_t(options.budget_ms * 1000.0)) };
+		table.NewSearch();
+
+		// Fall back to the best run this turn if not even depth 1 finishes
+		plan.action = search::GreedyAction(game, table);
+
+		for (int depth = 1; depth <= options.max_depth; depth++) {
+			int action = plan.action;
+			float value = detail::Value(game, depth, options.samples, seed, ctx, &action);
+			if (ctx.out_of_time) {
+				break;
+			}
+			plan.action = action;
+			plan.value = value;
+			plan.depth = depth;
+		}
+		plan.nodes = ctx.nodes;
+		return plan;
+	}
+}
@@ -0,0 +1,254 @@
+// Measures what each rule does to a game by playing paired games: the same
+// seed once with the rule forced on for the whole game and once with it
+// never enabled, everything else rolling as usual.
+//
+// Build (from the repository root):
+//	g++ -std=c++17 -O2 Run/RuleImpact.cpp -o rule_impact -lpthread
+//	cl /std:c++17 /O2 /EHsc Run\RuleImpact.cpp
+//
+// Usage:
+//	rule_impact [--rules a,b,...] [--length N] [--first N] [--min N] [--max N]
+//	            [--precision F] [--threads N]
+//
+// For every rule (all of them by default, keys as in possible_rules) it
+// reports the on minus off difference in final score, in score after the
+// same number of turns, in average run length and in the number of turns,
+// each with a 95% confidence interval.  Both
+// games of a pair share the seed, so the shuffled deck is the same and most
+// of the luck cancels out of the difference.  Pairs are played in rounds
+// until the score interval is within --precision of the average score with
+// the rule off (after at least --min pairs), or --max pairs.
+//
+// Games are played by the greedy player.  timed_turn has no effect in the
+// simulation, see Sim.h.  With discard_to_deck forced on the deck never runs
+// out, so games stop after one turn per card in the deck; the capped column
+// counts the pairs where that happened.  A capped game's final score only
+// says how long it was allowed to run, so when more than half the pairs are
+// capped the score column is marked with * and the equal turns column is the
+// one to read.  That compares both games of a pair after as many turns as
+// the shorter one lasted.
+
+#include "Search.h"
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+	// Welford's running mean and variance
+	struct Stat {
+		double n = 0.0;
+		double mean = 0.0;
+		double m2 = 0.0;
+
+		void Add(double x) {
+			n += 1.0;
+			double delta = x - mean;
+			mean += delta / n;
+			m2 += delta * (x - mean);
+		}
+
+		void Merge(const Stat& o) {
+			if (o.n == 0.0) {
+				return;
+			}
+			double total = n + o.n;
+			double delta = o.mean - mean;
+			mean += delta * o.n / total;
+			m2 += o.m2 + delta * delta * n * o.n / total;
+			n = total;
+		}
+
+		// Half width of the 95% confidence interval of the mean
+		double Interval() const {
+			return n > 1.0 ? 1.96 * std::sqrt(m2 / (n - 1.0) / n) : INFINITY;
+		}
+	};
+
+	struct GameStats {
+		int score = 0;
+		int turns = 0;
+		bool capped = false;
+		double run_length = 0.0; // average over turns that scored
+	};
+
+	struct PairStats {
+		Stat score;
+		Stat equal_turns_score;
+		Stat run_length;
+		Stat turns;
+		Stat off_score;
+		int capped = 0;
+
+		void Merge(const PairStats& o) {
+			capped += o.capped;
+			score.Merge(o.score);
+			equal_turns_score.Merge(o.equal_turns_score);
+			run_length.Merge(o.run_length);
+			turns.Merge(o.turns);
+			off_score.Merge(o.off_score);
+		}
+	};
+
+	struct Worker {
+		TranspositionTable table{ 16 << 20 };
+		sim::Game game;
+		PairStats stats;
+		// Score after each turn of the last pair's games
+		std::vector<int> on_score_after;
+		std::vector<int> off_score_after;
+	};
+
+	GameStats Play(Worker& worker, std::vector<int>& score_after, uint32_t seed, int length, uint32_t on, uint32_t off) {
+		sim::Game& game = worker.game;
+		game.forced_on = on;
+		game.forced_off = off;
+		game.Reset(seed, length);
+
+		GameStats stats;
+		score_after.clear();
+		int runs = 0;
+		int run_cards = 0;
+		int max_turns = game.deck_size;
+		while (!game.over && stats.turns < max_turns) {
+			int action = search::GreedyAction(game, worker.table);
+			if ((action == sim::END_TURN || action == sim::DISCARD) && game.in_play_size > 2) {
+				runs++;
+				run_cards += game.in_play_size;
+			}
+			game.Step(action);
+			if (action == sim::END_TURN || action == sim::DISCARD) {
+				stats.turns++;
+				score_after.push_back(game.score);
+			}
+		}
+		stats.score = game.score;
+		stats.capped = !game.over;
+		stats.run_length = runs > 0 ? double(run_cards) / runs : 0.0;
+		return stats;
+	}
+
+	void PlayPairs(Worker& worker, uint32_t first, int pairs, int length, uint32_t rule) {
+		for (int i = 0; i < pairs; i++) {
+			uint32_t seed = first + uint32_t(i);
+			GameStats on = Play(worker, worker.on_score_after, seed, length, rule, 0);
+			GameStats off = Play(worker, worker.off_score_after, seed, length, 0, rule);
+			int turns = std::min(on.turns, off.turns);
+			worker.stats.score.Add(on.score - off.score);
+			worker.stats.equal_turns_score.Add(turns > 0 ? worker.on_score_after[turns - 1] - worker.off_score_after[turns - 1] : 0);
+			worker.stats.run_length.Add(on.run_length - off.run_length);
+			worker.stats.turns.Add(on.turns - off.turns);
+			worker.stats.off_score.Add(off.score);
+			worker.stats.capped += on.capped || off.capped;
+		}
+	}
+
+	bool ParseRules(const std::string& spec, std::vector<sim::RuleBit>& rules) {
+		rules.clear();
+		size_t start = 0;
+		while (start <= spec.size()) {
+			size_t comma = spec.find(',', start);
+			sim::RuleBit rule = sim::RuleIndex(spec.substr(start, comma - start));
+			if (rule == sim::RULE_COUNT) {
+				return false;
+			}
+			rules.push_back(rule);
+			if (comma == std::string::npos) {
+				break;
+			}
+			start = comma + 1;
+		}
+		return true;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	std::vector<sim::RuleBit> rules;
+	for (int r = 0; r < int(sim::RULE_COUNT); r++) {
+		rules.push_back(sim::RuleBit(r));
+	}
+	int length = 5;
+	uint32_t first = 0;
+	int min_pairs = 200;
+	int max_pairs = 20000;
+	double precision = 0.01;
+	int threads = std::max(1, int(std::thread::hardware_concurrency()));
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool has_value = i + 1 < argc;
+		if (arg == "--rules" && has_value) {
+			if (!ParseRules(argv[++i], rules)) {
+				std::printf("Unknown rule in %s\n", argv[i]);
+				return 2;
+			}
+		}
+		else if (arg == "--length" && has_value) {
+			length = std::stoi(argv[++i]);
+		}
+		else if (arg == "--first" && has_value) {
+			first = uint32_t(std::stoul(argv[++i]));
+		}
+		else if (arg == "--min" && has_value) {
+			min_pairs = std::max(2, std::stoi(argv[++i]));
+		}
+		else if (arg == "--max" && has_value) {
+			max_pairs = std::stoi(argv[++i]);
+		}
+		else if (arg == "--precision" && has_value) {
+			precision = std::stod(argv[++i]);
+		}
+		else if (arg == "--threads" && has_value) {
+			threads = std::max(1, std::stoi(argv[++i]));
+		}
+		else {
+			std::printf("usage: %s [--rules a,b,...] [--length N] [--first N] [--min N] [--max N]\n"
+				"          [--precision F] [--threads N]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (length < 1 || length > sim::max_game_length) {
+		std::printf("Length must be 1 to %d\n", sim::max_game_length);
+		return 2;
+	}
+	max_pairs = std::max(max_pairs, min_pairs);
+
+	std::vector<Worker> workers(threads);
+	std::printf("length %d, on minus off with 95%% intervals\n", length);
+	std::printf("%-16s %7s %10s %19s %17s %16s %14s %7s\n", "rule", "pairs", "score off", "score", "equal turns", "run length", "turns", "capped");
+
+	for (sim::RuleBit rule : rules) {
+		PairStats total;
+		uint32_t next = first;
+		int batch = std::max(1, min_pairs / threads);
+
+		while (total.score.n < max_pairs) {
+			int round = int(std::min<double>(batch, std::ceil((max_pairs - total.score.n) / threads)));
+			std::vector<std::thread> pool;
+			for (int w = 0; w < threads; w++) {
+				workers[w].stats = {};
+				pool.emplace_back(PlayPairs, std::ref(workers[w]), next + uint32_t(w * round), round, length, sim::Bit(rule));
+			}
+			for (auto& thread : pool) {
+				thread.join();
+			}
+			for (auto& w : workers) {
+				total.Merge(w.stats);
+			}
+			next += uint32_t(threads * round);
+
+			if (total.score.n >= min_pairs && total.score.Interval() <= precision * std::abs(total.off_score.mean)) {
+				break;
+			}
+		}
+
+		bool capped = 2 * total.capped > total.score.n;
+		std::printf("%-16.*s %7.0f %10.1f %+8.1f +- %-6.1f%c %+7.1f +- %-6.1f %+7.2f +- %-5.2f %+6.1f +- %-5.1f %7d\n",
+			int(sim::rule_keys[rule].size()), sim::rule_keys[rule].data(), total.score.n, total.off_score.mean,
+			total.score.mean, total.score.Interval(), capped ? '*' : ' ', total.equal_turns_score.mean, total.equal_turns_score.Interval(),
+			total.run_length.mean, total.run_length.Interval(), total.turns.mean, total.turns.Interval(), total.capped);
+	}
+	return 0;
+}
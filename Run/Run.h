@@ -0,0 +1,1371 @@
+#pragma once
+
+// The game states and the Run engine class that drives them.
+
+#include "Game.h"
+#include "AllocStats.h"
+#include "Hint.h"
+#include "HitGrid.h"
+#include "LayerCache.h"
+#include "Tween.h"
+
+#include <cstdio>
+#include <optional>
+
+enum class GameState {
+	NONE,
+	START_SCREEN,
+	GAME_START, // Start of a game.
+	DRAW_CARDS, // Draw cards up to the hand limit
+	PICK_CARD, //Pick cards to play
+	END_TURN, //calcualte the score of the current play
+	END_GAME, //End of the game, show final score
+	ANIMATE_PLAY,
+	ANIMATE_UNPLAY,
+	LENGTH_SELECT,
+	TUTORIAL,
+};
+
+// Static names for each state, used for trace markers
+inline const char* GameStateName(GameState state) {
+	switch (state) {
+	case GameState::NONE: return "NONE";
+	case GameState::START_SCREEN: return "START_SCREEN";
+	case GameState::GAME_START: return "GAME_START";
+	case GameState::DRAW_CARDS: return "DRAW_CARDS";
+	case GameState::PICK_CARD: return "PICK_CARD";
+	case GameState::END_TURN: return "END_TURN";
+	case GameState::END_GAME: return "END_GAME";
+	case GameState::ANIMATE_PLAY: return "ANIMATE_PLAY";
+	case GameState::ANIMATE_UNPLAY: return "ANIMATE_UNPLAY";
+	case GameState::LENGTH_SELECT: return "LENGTH_SELECT";
+	case GameState::TUTORIAL: return "TUTORIAL";
+	}
+	return "UNKNOWN";
+}
+
+
+struct State {
+	olc::PixelGameEngine* pge;
+	explicit State(olc::PixelGameEngine* pge_) : pge(pge_) {};
+	virtual ~State() = default;
+	virtual void EnterState() {};
+	virtual GameState OnUserUpdate(float fElapsedTime) = 0;
+	virtual void ExitState() {};
+};
+
+// A press made while cards were still moving, handed on to PickCardState once
+// they have landed so a click during an animation is not lost.  Entering any
+// other state drops it, so it can never press Restart.
+inline std::optional<olc::vf2d> pending_press;
+
+// Lands every tween at once on a press, or when a press is already waiting,
+// keeping the press for PickCardState
+inline void FinishOnPress(olc::PixelGameEngine* pge, TweenSet& tweens) {
+	if (pge->GetMouse(0).bPressed) {
+		pending_press = pge->GetMousePos();
+	}
+	if (pending_press) {
+		tweens.FinishAll();
+	}
+}
+
+struct Button {
+	std::string text;
+	olc::vf2d pos;
+	olc::vf2d size;
+	olc::vf2d text_size;
+	int value;
+};
+
+struct StartScreenState : public State {
+	// Start and tutorial buttons, hit ids are the state each one leads to
+	olc::vf2d button_pos;
+	olc::vf2d button_size;
+	olc::vf2d tutorial_pos;
+	olc::vf2d tutorial_size;
+	HitGrid hits;
+
+	StartScreenState(olc::PixelGameEngine* pge) : State(pge), hits(pge->ScreenWidth(), pge->ScreenHeight()) {
+		button_pos = olc::vf2d{ pge->ScreenWidth() / 3.0f, pge->ScreenHeight() * 2.0f / 3.0f };
+		button_size = olc::vf2d{ pge->ScreenWidth() / 3.0f, pge->ScreenHeight() / 6.0f };
+		tutorial_pos = olc::vf2d{ pge->ScreenWidth() / 3.0f, pge->ScreenHeight() * 5.0f / 6.0f + 2.0f };
+		tutorial_size = olc::vf2d{ pge->ScreenWidth() / 3.0f, pge->ScreenHeight() / 12.0f };
+		hits.Add(int(GameState::LENGTH_SELECT), button_pos, button_size);
+		hits.Add(int(GameState::TUTORIAL), tutorial_pos, tutorial_size);
+	};
+
+	std::vector<Card> left_cards;
+	std::vector<Card> right_cards;
+	std::vector<Card> center_cards;
+
+
+	void EnterState() override {
+		constexpr olc::vf2d text_size = olc::TextSize("RUN");
+
+		hand.cards.clear();
+		the_deck.clear();
+		in_play.cards.clear();
+		enabled_rules.clear();
+
+		olc::vf2d center = olc::vf2d{ 128.0f, 100.0f } - card_size / 2.0f;
+
+		// Only need to generate the title cards the very first time
+		if (!center_cards.size()) {
+			center_cards = {
+				{
+					card_size,
+					{
+						&shape_primitives[3],
+						shape_colors[6],
+						6
+					},
+					card_colors[6], 1, 'R', center - olc::vf2d{card_size.x + 1.0f, 0.0f}
+				},
+				{
+					card_size,
+					{
+						&shape_primitives[4],
+						shape_colors[6],
+						6
+					},
+					card_colors[6], 2, 'U', center
+				},
+				{
+					card_size,
+					{
+						&shape_primitives[5],
+						shape_colors[6],
+						6
+					},
+					card_colors[6], 3, 'N', center + olc::vf2d{card_size.x + 1.0f, 0.0f}
+				},
+			};
+			for (int i = 0; i < 6; i++) {
+				Card c;
+				c.size = card_size;
+				c.color = card_colors[i];
+				c.shape.primitive = &shape_primitives[i + 3];
+				c.shape.color = shape_colors[i];
+				c.shape.color_index = i;
+				c.number = i + 1;
+				c.letter = "ABCDEF"[i];
+				c.position = olc::vf2d{ 0.0f + i * (89.5f / 6.0f), 82.5f};
+				left_cards.push_back(c);
+				c.position = olc::vf2d{ 231.0f - i * (89.5f / 6.0f), 82.5f };
+				right_cards.push_back(c);
+			}
+		}
+
+
+	}
+
+	GameState OnUserUpdate(float fElapsedTime) override {
+		screen_cache.Draw(pge, this, 0, [&] {
+			for (int i = 0; i < 6; i++) {
+				left_cards[i].Draw(pge, (i + 1) * (1.0f / 7.0f));
+				right_cards[i].Draw(pge, (i + 1) * (1.0f / 7.0f));
+			}
+
+			for (const auto& c : center_cards) {
+				c.Draw(pge);
+			}
+
+			pge->FillRectDecal(button_pos, button_size, olc::DARK_GREY);
+
+			constexpr olc::vf2d text_size = olc::TextSize("Start");
+
+			olc::vf2d scale = (button_size) / text_size;
+
+			pge->DrawStringDecal(button_pos + olc::vf2d{ 2.0, 2.0 }, "Start", olc::BLACK, scale);
+
+			pge->FillRectDecal(tutorial_pos, tutorial_size, olc::DARK_GREY);
+
+			constexpr olc::vf2d tutorial_text_size = olc::TextSize("Tutorial");
+			scale = (tutorial_size) / tutorial_text_size;
+
+			pge->DrawStringDecal(tutorial_pos + olc::vf2d{ 1.0, 1.0 }, "Tutorial", olc::BLACK, scale);
+		});
+
+		int hit = hits.Pressed(pge);
+		return hit >= 0 ? GameState(hit) : GameState::START_SCREEN;
+	}
+};
+
+struct GameStartState : public State {
+	GameStartState(olc::PixelGameEngine* pge) : State(pge) {};
+
+	void EnterState() override { 
+		//Initialize the hand back to the default configuration
+		hand.max_size = 7;
+		hand.cards.clear();
+
+		//Clear the deck and discard
+		the_deck.clear();
+		the_discard.clear();
+
+		//Create a new deck with the default configuration
+		the_deck.cards = CreateDeck(game_length, game_length, game_length);
+
+		//Shuffle the deck
+		RUN_TRACE_SCOPE("Shuffle");
+		the_deck.Shuffle(rng);
+	}
+
+	GameState OnUserUpdate(float fElapsedTime) override {
+		//hand.Draw(pge, olc::vf2d{ 128.0f, 205.0f });
+		return GameState::DRAW_CARDS;
+	}
+};
+
+struct DrawCardsState : public State {
+	DrawCardsState(olc::PixelGameEngine* pge) : State(pge) {};
+
+	// Seconds for the new cards to slide into the hand
+	const float duration = 1.0f / 1.8f;
+	TweenSet tweens;
+
+	void EnterState() override {
+		tweens.Clear();
+		int cards_to_draw = std::min(hand.max_size - hand.cards.size(), the_deck.size());
+		if (cards_to_draw <= 0) {
+			return;
+		}
+
+		int kept = hand.cards.size();
+		for (int i = 0; i < cards_to_draw; i++) {
+			hand.Add(the_deck.Pop());
+		}
+
+		// Add lays the hand out again, the cards already held slide left to
+		// make room and the new ones come up from below the screen
+		olc::vf2d room = { cards_to_draw * (card_size.x / 2.0f + 0.5f), 0.0f };
+		for (int i = 0; i < hand.cards.size(); i++) {
+			olc::vf2d spot = hand.cards[i].position;
+			hand.cards[i].position = i < kept ? spot + room : olc::vf2d{ spot.x, float(pge->ScreenHeight()) };
+			tweens.Start(&hand.cards[i].position, spot, duration);
+		}
+	}
+
+	GameState OnUserUpdate(float fElapsedTime) override {
+		GameState next_state = GameState::DRAW_CARDS;
+
+		FinishOnPress(pge, tweens);
+		tweens.Update(fElapsedTime);
+
+		// The turn's time only starts once the hand is dealt
+		if (!tweens.Active()) {
+			fTurnStart = fTotalTime;
+			next_state = hand.cards.size() < 3 ? GameState::END_GAME : GameState::PICK_CARD;
+		}
+
+		DrawEndButton(pge);
+		DrawDiscardButton(pge);
+		DrawNormalInterface(pge);
+
+		return next_state;
+	}
+};
+
+// Ends the turn without scoring, the hand goes back into the deck under
+// discard_to_deck.  It is kept in the_discard to be drawn leaving the table.
+inline void DiscardHand() {
+	if (RuleEnabled("discard_to_deck")) {
+		the_deck.Insert(std::begin(hand.cards), std::end(hand.cards), rng);
+	}
+
+	the_discard.insert(std::end(the_discard), std::begin(hand.cards), std::end(hand.cards));
+	hand.cards.clear();
+}
+
+// Hit ids on the table while picking a card, hand card i is HIT_HAND + i
+enum TableHit {
+	HIT_END_TURN,
+	HIT_DISCARD,
+	HIT_UNPLAY,
+	HIT_HAND,
+};
+
+struct PickCardState : public State {
+	HitGrid hits;
+
+	PickCardState(olc::PixelGameEngine* pge) : State(pge), hits(pge->ScreenWidth(), pge->ScreenHeight()) {};
+
+	// Cards only move between turns and in the animation states, so the
+	// layout is registered once each time a card can be picked
+	void EnterState() override {
+		hits.Clear();
+		for (int i = 0; i < hand.cards.size(); i++) {
+			hits.Add(HIT_HAND + i, hand.cards[i].position, card_size);
+		}
+		// The last in play card can be taken back
+		if (in_play.cards.size() && !in_play.cards.back().locked) {
+			hits.Add(HIT_UNPLAY, in_play.view.WorldToScreen(in_play.cards.back().position), in_play.view.ScaleToScreen(card_size));
+		}
+		// The end turn button only works once a long enough run has been made
+		if (in_play.cards.size() > 2) {
+			hits.Add(HIT_END_TURN, end_button_pos, table_button_size);
+		}
+		hits.Add(HIT_DISCARD, discard_button_pos, table_button_size);
+	}
+
+	GameState OnUserUpdate(float fElapsedTime) override {
+		GameState next_state = GameState::PICK_CARD;
+
+		int hit = hits.Pressed(pge);
+		if (pending_press) {
+			hit = hits.At(*pending_press);
+			pending_press.reset();
+		}
+		if (hit >= HIT_HAND) {
+			int i = hit - HIT_HAND;
+			if (i < sim::mask_cards && (hand.PlayableMask() & (1u << i))) {
+				card_played_index = i;
+				next_state = GameState::ANIMATE_PLAY;
+			}
+		}
+		else if (hit == HIT_UNPLAY) {
+			next_state = GameState::ANIMATE_UNPLAY;
+		}
+		else if (hit == HIT_END_TURN) {
+			next_state = GameState::END_TURN;
+		}
+
+		// Discarding ends a turn but grants no points and discards the hand
+		if (hit == HIT_DISCARD || (RuleEnabled("timed_turn") && TurnTimeLeft() <= 0)) {
+			DiscardHand();
+			next_state = GameState::END_TURN;
+		}
+
+		DrawEndButton(pge, in_play.cards.size() > 2);
+		DrawDiscardButton(pge, true);
+		DrawNormalInterface(pge);
+
+		return next_state;
+	}
+};
+
+struct EndTurnState : public State{
+	EndTurnState(olc::PixelGameEngine* pge) : State(pge) {}
+
+	// Seconds for the run and any discarded hand to slide off the table
+	const float duration = 1.0f / 1.8f;
+	TweenSet tweens;
+
+	void EnterState() override {
+
+		//At the end of every round, there is a base 33%% chance to gain or refresh a random rule
+		//the chance lowers if there are more rules added
+		int rand_val = std::uniform_int_distribution<>(0, 5 + enabled_rules.size())(rng);
+		if (rand_val < 2) {
+			// Select a rule at random
+			rand_val = std::uniform_int_distribution<>(0, possible_rules.size() - 1)(rng);
+			auto rule = possible_rules.begin();
+			std::advance(rule, rand_val);
+			enabled_rules[rule->second.key] = rule->second;
+		}
+
+		if (in_play.cards.size() > 2) {
+			score += Score(in_play.cards);
+		}
+
+		if (RuleEnabled("discard_to_deck")) {
+			//Return the run to random places in the deck
+			RUN_TRACE_SCOPE("Insert");
+			for (auto& c : in_play.cards) {
+				c.locked = false;
+			}
+			the_deck.Insert(std::begin(in_play.cards), std::end(in_play.cards), rng);
+		}
+
+		// The run leaves from where it is drawn, on the screen at the row's
+		// zoom.  Cards the view has scrolled past are not drawn, so not kept.
+		the_discard.reserve(the_discard.size() + in_play.cards.size());
+		for (Card c : in_play.cards) {
+			if (!in_play.view.IsRectVisible(c.position, c.size)) {
+				continue;
+			}
+			c.position = in_play.view.WorldToScreen(c.position);
+			c.scale = in_play.view.GetWorldScale();
+			the_discard.push_back(c);
+		}
+		in_play.cards.clear();
+
+		tweens.Clear();
+		tweens.Reserve(the_discard.size());
+		for (auto& c : the_discard) {
+			tweens.Start(&c.position, { c.position.x, float(pge->ScreenHeight()) }, duration);
+		}
+	}
+
+	GameState OnUserUpdate(float fElapsedTime) override {
+		GameState next_state = GameState::END_TURN;
+
+		FinishOnPress(pge, tweens);
+		tweens.Update(fElapsedTime);
+
+		if (!tweens.Active()) {
+			the_discard.clear();
+			next_state = GameState::DRAW_CARDS;
+		}
+
+		DrawEndButton(pge);
+		DrawDiscardButton(pge);
+		DrawNormalInterface(pge);
+
+		return next_state;
+	}
+
+	void ExitState() override {
+		for (const auto& [key, rule] : possible_rules) {
+			if (rule.tick_on_end) {
+				TickRule(rule.key);
+			}
+		}
+	}
+};
+
+struct EndGameState : public State {
+	EndGameState(olc::PixelGameEngine* pge) : State(pge) {};
+
+	void EnterState() override {
+		hand.cards.clear();
+		in_play.cards.clear();
+		the_deck.clear();
+		enabled_rules.clear();
+	}
+
+	const std::string final_score_str = "Final Score:";
+	const std::string restart = "Restart";
+	Label score_label{ "" };
+
+	static constexpr olc::vf2d final_size = olc::TextSize("Final Score:");
+	static constexpr olc::vf2d restart_size = olc::TextSize("Restart");
+	const olc::vf2d button_pos = olc::vf2d{ 127.0f, 179.0f } - restart_size / 2.0f;
+	const olc::vf2d button_size = restart_size + olc::vf2d{ 2.0f, 2.0f };
+
+	GameState OnUserUpdate(float fElapsedTime) override {
+		const std::string& score_str = score_label.Get(score);
+
+		olc::vf2d final_score_str_pos = olc::vf2d{ 128.0f, 110.0f } - final_size / 2.0f;
+		olc::vf2d score_size = olc::TextSize(score_str);
+		olc::vf2d score_pos = olc::vf2d{ 128.0f, 120.0f } - score_size / 2.0f;
+
+		pge->DrawStringDecal(final_score_str_pos, final_score_str);
+		pge->DrawStringDecal(score_pos, score_str);
+		// Draw a restart button
+		pge->FillRectDecal(button_pos, button_size, olc::DARK_GREY);
+		pge->DrawStringDecal(button_pos + olc::vf2d{ 1.0f, 1.0f }, restart, olc::BLACK);
+
+		// A lone button needs no grid
+		if (pge->GetMouse(0).bPressed && PointInRect(pge->GetMousePos(), button_pos, button_size)) {
+			score = 0;
+			return GameState::START_SCREEN;
+		}
+
+		return GameState::END_GAME;
+	}
+};
+
+struct PlayCardAnimationState : public State {
+	PlayCardAnimationState(olc::PixelGameEngine* pge) : State(pge) {};
+
+	// Seconds for the cards to reach their new spots
+	const float duration = 1.0f / 1.8f;
+	TweenSet tweens;
+
+	void EnterState() override {
+		tweens.Clear();
+		in_play.Fit(in_play.cards.size() + 1);
+
+		//Figure out where all the in_play cards will be moving to.  The card being moved will be the last card.
+		olc::vf2d position = { in_play.position.x - (in_play.cards.size() + 1) * (card_size.x / 2.0f + 0.5f), in_play.position.y };
+		olc::vf2d increment = { card_size.x + 1.0f, 0.0f };
+		for (int i = 0; i < in_play.cards.size(); i++) {
+			tweens.Start(&in_play.cards[i].position, position, duration);
+			position += increment;
+		}
+		// The ending position of the card being played, which is still drawn
+		// in the hand on the screen rather than in the board's view
+		olc::vf2d end_pos = in_play.view.WorldToScreen(position);
+
+
+		// Figure out where all the cards in hand will be moving to.
+		position = { hand.position.x - (hand.cards.size() - 1) * (card_size.x / 2.0f + 0.5f), hand.position.y};
+		for (int i = 0; i < hand.cards.size(); i++) {
+			//If this is the card that was played, its moving across the screen
+			tweens.Start(&hand.cards[i].position, i == card_played_index ? end_pos : position, duration);
+			//and shrinking to the row's zoom, so it lands at the size it is drawn at
+			if (i == card_played_index) {
+				tweens.Start(&hand.cards[i].scale, in_play.view.GetWorldScale(), duration);
+			}
+			//If this is the card that was played, don't bump the position
+			position += i == card_played_index ? olc::vf2d{0.0f, 0.0f} : increment;
+		}
+	}
+
+	GameState OnUserUpdate(float fElapsedTime) override {
+		GameState next_state = GameState::ANIMATE_PLAY;
+
+		FinishOnPress(pge, tweens);
+		tweens.Update(fElapsedTime);
+
+		// The cards are only moved between hand and play once all have arrived
+		if (!tweens.Active()) {
+			in_play.Add(hand.cards[card_played_index]);
+			hand.cards.erase(hand.cards.begin() + card_played_index);
+			next_state = GameState::PICK_CARD;
+		}
+
+		DrawEndButton(pge);
+		DrawDiscardButton(pge);
+		DrawNormalInterface(pge);
+
+		return next_state;
+	}
+
+	void ExitState() override {
+		for (const auto& [key, rule] : possible_rules) {
+			if (rule.tick_on_play) {
+				TickRule(rule.key);
+			}
+		}
+	}
+};
+
+struct UnPlayCardAnimationState : public State {
+	UnPlayCardAnimationState(olc::PixelGameEngine* pge) : State(pge) {};
+
+	// Seconds for the cards to reach their new spots
+	const float duration = 1.0f / 1.8f;
+	TweenSet tweens;
+
+	void EnterState() override {
+		tweens.Clear();
+		in_play.Fit(in_play.cards.size() - 1);
+
+		//Figure out where all the in_play cards will be moving to.  The card being moved will be the last card.
+		olc::vf2d position = { in_play.position.x - (in_play.cards.size() - 1) * (card_size.x / 2.0f + 0.5f), in_play.position.y };
+		olc::vf2d increment = { card_size.x + 1.0f, 0.0f };
+		for (int i = 0; i < in_play.cards.size(); i++) {
+			tweens.Start(&in_play.cards[i].position, position, duration);
+			position += increment;
+		}
+
+		// Figure out where all the cards in hand will be moving to.
+		position = { hand.position.x - (hand.cards.size() + 1) * (card_size.x / 2.0f + 0.5f), hand.position.y };
+		for (int i = 0; i < hand.cards.size(); i++) {
+			tweens.Start(&hand.cards[i].position, position, duration);
+			position += increment;
+		}
+
+		// Only the last card can be un-played, setup its new movement position.
+		// It is drawn in the board's view until it reaches the hand, growing
+		// out of the row's zoom to the hand's size on the way.
+		tweens.Start(&in_play.cards.back().position, in_play.view.ScreenToWorld(position), duration);
+		tweens.Start(&in_play.cards.back().scale, 1.0f / in_play.view.GetWorldScale(), duration);
+	}
+
+	GameState OnUserUpdate(float fElapsedTime) override {
+		GameState next_state = GameState::ANIMATE_UNPLAY;
+
+		FinishOnPress(pge, tweens);
+		tweens.Update(fElapsedTime);
+
+		// The cards are only moved between hand and play once all have arrived
+		if (!tweens.Active()) {
+			hand.Add(in_play.cards.back());
+			in_play.cards.pop_back();
+			next_state = GameState::PICK_CARD;
+		}
+
+		DrawEndButton(pge);
+		DrawDiscardButton(pge);
+		DrawNormalInterface(pge);
+
+		return next_state;
+	}
+};
+
+struct LengthSelectState : public State {
+
+	std::array<Button, 5> buttons;
+	HitGrid hits;
+
+	LengthSelectState(olc::PixelGameEngine* pge) : State(pge), hits(pge->ScreenWidth(), pge->ScreenHeight()) {
+		//Setup the buttons
+		buttons[0].text = "Normal";
+		buttons[0].pos = { 88.0f, 91.0f };
+		buttons[0].size = { 80.0f, 10.0f };
+		buttons[0].text_size = pge->GetTextSize(buttons[0].text);
+		buttons[0].value = 5;
+
+		buttons[1].text = "Medium";
+		buttons[1].pos = { 88.0f, 103.0f };
+		buttons[1].size = { 80.0f, 10.0f };
+		buttons[1].text_size = pge->GetTextSize(buttons[1].text);
+		buttons[1].value = 6;
+
+		buttons[2].text = "Long";
+		buttons[2].pos = { 88.0f, 115.0f };
+		buttons[2].size = { 80.0f, 10.0f };
+		buttons[2].text_size = pge->GetTextSize(buttons[2].text);
+		buttons[2].value = 7;
+
+		buttons[3].text = "Too Long";
+		buttons[3].pos = { 88.0f, 127.0f };
+		buttons[3].size = { 80.0f, 10.0f };
+		buttons[3].text_size = pge->GetTextSize(buttons[3].text);
+		buttons[3].value = 9;
+
+		buttons[4].text = "Back";
+		buttons[4].pos = { 88.0f, 139.0f };
+		buttons[4].size = { 80.0f, 10.0f };
+		buttons[4].text_size = pge->GetTextSize(buttons[4].text);
+		buttons[4].value = 0;
+
+		// Hit ids are indices into buttons
+		for (int i = 0; i < buttons.size(); i++) {
+			hits.Add(i, buttons[i].pos, buttons[i].size);
+		}
+	};
+
+	GameState OnUserUpdate(float fElapsedTime) override {
+		GameState next_state = GameState::LENGTH_SELECT;
+
+		screen_cache.Draw(pge, this, 0, [&] {
+			for (const auto& button : buttons) {
+				pge->FillRectDecal(button.pos, button.size, olc::DARK_GREY);
+				olc::vf2d text_pos = button.pos + button.size / 2.0f - button.text_size / 2.0f;
+				pge->DrawStringDecal(text_pos, button.text, olc::BLACK);
+			}
+		});
+
+		int hit = hits.Pressed(pge);
+		if (hit >= 0) {
+			game_length = buttons[hit].value;
+			next_state = game_length != 0 ? GameState::GAME_START : GameState::START_SCREEN;
+		}
+
+		return next_state;
+	}
+};
+
+struct TutorialState : public State {
+	TutorialState(olc::PixelGameEngine* pge) : State(pge) {};
+
+	struct TextData {
+		olc::vf2d pos;
+		std::string str;
+		olc::Pixel color = olc::WHITE;
+	};
+
+	struct RectData {
+		olc::vf2d pos;
+		olc::vf2d size;
+		olc::Pixel color = olc::YELLOW;
+	};
+
+	struct LineData {
+		olc::vf2d pos_a;
+		olc::vf2d pos_b;
+		olc::Pixel color = olc::WHITE;
+	};
+
+	struct TutorialData {
+		bool draw_hand;
+		bool draw_in_play;
+		bool draw_end_turn;
+		bool draw_discard;
+		bool draw_color_track;
+
+		std::vector<TextData> text;
+		std::vector<RectData> rects;
+		std::vector<LineData> lines;
+	};
+
+	std::mt19937 tutorial_rng;
+
+	int tutorial_id = 0;
+
+	std::vector<TutorialData> tutorial_data = {
+		{
+			true, true, false, false, true,
+			{
+				{{10.0f, 10.0f}, std::string{"Your objective is to play runs"}},
+				{{10.0f, 20.0f}, std::string{"of cards from your hand.  Long"}},
+				{{10.0f, 30.0f}, std::string{"runs are worth more points."}},
+				{{10.0f, 40.0f}, std::string{"Each card has 4 main values."}},
+				{{53.0f, 108.0f}, std::string{"Number"}},
+				{{165.0f, 147.0f}, std::string{"Letter"}},
+				{{53.0f, 147.0f}, std::string{"Shape"}},
+				{{165.0f, 108.0f}, std::string{"Color"}},
+				{{10.0f, 170.0f}, std::string{"Click to continue"}},
+			},
+			{},
+			{
+				{{100.0f, 113.0f}, {116.0f, 121.0f}},
+				{{93.0f,  151.0f}, {120.0f, 143.0f}},
+				{{165.0f, 115.0f}, {138.0f, 124.0f}},
+				{{163.0f, 151.0f}, {138.0f, 151.0f}},
+			}
+		},
+		{
+			true, true, false, false, true,
+			{
+				{{10.0f, 10.0f}, std::string{"To count as a run only one of"}},
+				{{10.0f, 20.0f}, std::string{"these values needs to increment"}},
+				{{10.0f, 30.0f}, std::string{"from card to card."}},
+				{{53.0f, 108.0f}, std::string{"Number"}},
+				{{165.0f, 147.0f}, std::string{"Letter"}},
+				{{53.0f, 147.0f}, std::string{"Shape"}},
+				{{165.0f, 108.0f}, std::string{"Color"}},
+				{{10.0f, 170.0f}, std::string{"Click to continue"}},
+			},
+			{},
+			{
+				{{100.0f, 113.0f}, {116.0f, 121.0f}},
+				{{93.0f,  151.0f}, {120.0f, 143.0f}},
+				{{165.0f, 115.0f}, {138.0f, 124.0f}},
+				{{163.0f, 151.0f}, {138.0f, 151.0f}},
+			}
+		},
+		{
+			true, true, false, false, true,
+			{
+				{{10.0f, 10.0f}, std::string{"The color track at the bottom"}},
+				{{10.0f, 20.0f}, std::string{"of the screen shows the order"}},
+				{{10.0f, 30.0f}, std::string{"of colors from lowest value on"}},
+				{{10.0f, 40.0f}, std::string{"the left to highest value on"}},
+				{{10.0f, 50.0f}, std::string{"the right."}},
+				{{10.0f, 170.0f}, std::string{"Click to continue"}},
+			},
+			{
+				{{92.0f, 192.0f}, {72.0f, 12.0f}, olc::YELLOW}
+			}
+		},
+		{
+			true, true, false, false, true,
+			{
+				{{10.0f, 10.0f}, std::string{"The current run is here in the"}},
+				{{10.0f, 20.0f}, std::string{"middle of the screen."}},
+				{{10.0f, 170.0f}, std::string{"Click to continue"}},
+			},
+			{
+				{{6.0f, 117.0f}, {243.0f, 41.0f}, olc::YELLOW}
+			}
+		},
+		{
+			true, true, false, false, true,
+			{
+				{{10.0f, 10.0f}, std::string{"Your current hand is at the"}},
+				{{10.0f, 20.0f}, std::string{"bottom of the screen."}},
+				{{10.0f, 170.0f}, std::string{"Click to continue"}},
+			},
+			{
+				{{6.0f, 200.0f}, {243.0f, 41.0f}, olc::YELLOW}
+			}
+		},
+		{
+			true, true, false, false, true,
+			{
+				{{10.0f, 10.0f}, std::string{"You can unplay the last card"}},
+				{{10.0f, 20.0f}, std::string{"of the run and return it to"}},
+				{{10.0f, 30.0f}, std::string{"your hand."}},
+				{{10.0f, 170.0f}, std::string{"Click to continue"}},
+			},
+			{
+				{{140.0f, 119.0f}, {27.0f, 37.0f}, olc::YELLOW},
+			}
+		},
+		{
+			true, true, true, false, true,
+			{
+				{{10.0f, 10.0f}, std::string{"If you have a run of length"}},
+				{{10.0f, 20.0f}, std::string{"at least 3 you may end your"}},
+				{{10.0f, 30.0f}, std::string{"turn and score the run with"}},
+				{{10.0f, 40.0f}, std::string{"the end turn button."}},
+				{{10.0f, 170.0f}, std::string{"Click to continue"}},
+			},
+			{
+				{{1.0f, 191.0f}, {82.0f, 13.0f}, olc::YELLOW}
+			}
+		},
+		{
+			true, true, false, true, true,
+			{
+				{{10.0f, 10.0f}, std::string{"You may discard your hand at"}},
+				{{10.0f, 20.0f}, std::string{"any time with the discard"}},
+				{{10.0f, 30.0f}, std::string{"button.  This throws away all"}},
+				{{10.0f, 40.0f}, std::string{"cards in your hand and draws"}},
+				{{10.0f, 50.0f}, std::string{"new cards on the next turn."}},
+				{{10.0f, 60.0f}, std::string{"If a valid run is present then"}},
+				{{10.0f, 70.0f}, std::string{"it will still be scored."}},
+				{{10.0f, 170.0f}, std::string{"Click to continue"}},
+			},
+			{
+				{{172.0f, 191.0f}, {84.0f, 13.0f}, olc::YELLOW}
+			}
+		},
+		{
+			true, true, false, true, true,
+			{
+				{{10.0f, 10.0f}, std::string{"In either case you will draw"}},
+				{{10.0f, 20.0f}, std::string{"back up to your maximum hand"}},
+				{{10.0f, 30.0f}, std::string{"size and begin a new turn."}},
+				{{10.0f, 170.0f}, std::string{"Click to continue"}},
+			},
+		},
+		{
+			true, true, false, true, true,
+			{
+				{{10.0f, 10.0f}, std::string{"Score: 0"}},
+				{{10.0f, 20.0f}, std::string{"Deck : 118"}},
+				{{10.0f, 30.0f}, std::string{"The current score and number"}},
+				{{10.0f, 40.0f}, std::string{"of cards left in the deck are"}},
+				{{10.0f, 50.0f}, std::string{"both shown in the top left."}},
+				{{10.0f, 60.0f}, std::string{"The game ends when the deck is"}},
+				{{10.0f, 70.0f}, std::string{"empty and no run can be made."}},
+				{{10.0f, 170.0f}, std::string{"Click to continue"}},
+			},
+			{
+				{{8.0f, 8.0f}, {84.0f, 22.0f}, olc::YELLOW}
+			}
+		},
+		{
+			true, true, false, false, true,
+			{
+				{{10.0f, 10.0f}, std::string{"Runs are scored primarily on"}},
+				{{10.0f, 20.0f}, std::string{"their length.  A run of 3 has"}},
+				{{10.0f, 30.0f}, std::string{"a base score of 2 while a run"}},
+				{{10.0f, 40.0f}, std::string{"of 6 has a base score of 8."}},
+				{{10.0f, 50.0f}, std::string{"Repeating card values within a"}},
+				{{10.0f, 60.0f}, std::string{"run gives a point bonus"}},
+				{{10.0f, 170.0f}, std::string{"Click to continue"}},
+			},
+		},
+		{
+			true, true, false, false, true,
+			{
+				{{10.0f, 10.0f}, std::string{"This run has a length of 3 for"}},
+				{{10.0f, 20.0f}, std::string{"a base score of 2."}},
+				{{2.0f, 110.0f}, std::string{"Length - 2"}},
+				{{10.0f, 160.0f}, std::string{"Total - 2"}},
+				{{10.0f, 170.0f}, std::string{"Click to continue"}},
+			},
+			{
+				{{88.0f, 118.0f}, {80.0f, 39.0f}, olc::YELLOW}
+			}
+		},
+		{
+			true, true, false, false, true,
+			{
+				{{10.0f, 10.0f}, std::string{"No number appears more than"}},
+				{{10.0f, 20.0f}, std::string{"one time.  The number bonus"}},
+				{{10.0f, 30.0f}, std::string{"is 0 points."}},
+				{{2.0f, 110.0f}, std::string{"Length - 2"}},
+				{{2.0f, 120.0f}, std::string{"Number - 0"}},
+				{{10.0f, 160.0f}, std::string{"Total - 2"}},
+				{{10.0f, 170.0f}, std::string{"Click to continue"}},
+			},
+			{
+				{{90.0f, 121.0f}, {10.0f, 10.0f}, olc::YELLOW},
+				{{116.0f, 121.0f}, {10.0f, 10.0f}, olc::YELLOW},
+				{{142.0f, 121.0f}, {10.0f, 10.0f}, olc::YELLOW},
+			}
+		},
+		{
+			true, true, false, false, true,
+			{
+				{{10.0f, 10.0f}, std::string{"No letter appears more than"}},
+				{{10.0f, 20.0f}, std::string{"one time.  The letter bonus"}},
+				{{10.0f, 30.0f}, std::string{"is 0 points."}},
+				{{2.0f, 110.0f}, std::string{"Length - 2"}},
+				{{2.0f, 120.0f}, std::string{"Number - 0"}},
+				{{2.0f, 130.0f}, std::string{"Letter - 0"}},
+				{{10.0f, 160.0f}, std::string{"Total - 2"}},
+				{{10.0f, 170.0f}, std::string{"Click to continue"}},
+			},
+			{
+				{{103.0f, 144.0f}, {10.0f, 10.0f}, olc::YELLOW},
+				{{129.0f, 144.0f}, {10.0f, 10.0f}, olc::YELLOW},
+				{{155.0f, 144.0f}, {10.0f, 10.0f}, olc::YELLOW},
+			}
+		},
+		{
+			true, true, false, false, true,
+			{
+				{{10.0f, 10.0f}, std::string{"A heptagon is the most common"}},
+				{{10.0f, 20.0f}, std::string{"shape; appearing 2 times.  The"}},
+				{{10.0f, 30.0f}, std::string{"shape bonus is 1 point."}},
+				{{2.0f, 110.0f}, std::string{"Length - 2"}},
+				{{2.0f, 120.0f}, std::string{"Number - 0"}},
+				{{2.0f, 130.0f}, std::string{"Letter - 0"}},
+				{{10.0f, 140.0f}, std::string{"Shape - 1"}},
+				{{10.0f, 160.0f}, std::string{"Total - 3"}},
+				{{10.0f, 170.0f}, std::string{"Click to continue"}},
+			},
+			{
+				{{91.0f, 127.0f}, {21.0f, 21.0f}, olc::YELLOW},
+				{{143.0f, 127.0f}, {21.0f, 21.0f}, olc::YELLOW},
+			}
+		},
+		{
+			true, true, false, false, true,
+			{
+				{{10.0f, 10.0f}, std::string{"The most common card color is "}},
+				{{10.0f, 20.0f}, std::string{"green; appearing 2 times."}},
+				{{10.0f, 30.0f}, std::string{"The color bonus is 1 point."}},
+				{{2.0f, 110.0f}, std::string{"Length - 2"}},
+				{{2.0f, 120.0f}, std::string{"Number - 0"}},
+				{{2.0f, 130.0f}, std::string{"Letter - 0"}},
+				{{10.0f, 140.0f}, std::string{"Shape - 1"}},
+				{{10.0f, 150.0f}, std::string{"Color - 1"}},
+				{{10.0f, 160.0f}, std::string{"Total - 4"}},
+				{{10.0f, 170.0f}, std::string{"Click to continue"}},
+			},
+			{
+				{{88.0f, 119.0f}, { 27.0f, 37.0f }, olc::YELLOW},
+				{ {140.0f, 119.0f}, {27.0f, 37.0f}, olc::YELLOW },
+			}
+		},
+		{
+			true, true, false, false, true,
+			{
+				{{10.0f, 10.0f}, std::string{"The total score for this run"}},
+				{{10.0f, 20.0f}, std::string{"is 4 points."}},
+				{{2.0f, 110.0f}, std::string{"Length - 2"}},
+				{{2.0f, 120.0f}, std::string{"Number - 0"}},
+				{{2.0f, 130.0f}, std::string{"Letter - 0"}},
+				{{10.0f, 140.0f}, std::string{"Shape - 1"}},
+				{{10.0f, 150.0f}, std::string{"Color - 1"}},
+				{{10.0f, 160.0f}, std::string{"Total - 4"}},
+				{{10.0f, 170.0f}, std::string{"Click to continue"}},
+			},
+		},
+		{
+			true, true, false, false, true,
+			{
+				{{10.0f, 40.0f}, std::string{"On occasion additional game"}},
+				{{10.0f, 50.0f}, std::string{"rules will be added.  These"}},
+				{{10.0f, 60.0f}, std::string{"are shown in the top right and"}},
+				{{10.0f, 70.0f}, std::string{"do what they say."}},
+				{{10.0f, 170.0f}, std::string{"Click to return to title"}},
+			},
+			{
+				{{128.0f, 10.0f}, {126.0f, 24.0f}, olc::YELLOW}
+			}
+		},
+	};
+
+
+
+	void EnterState() override {
+		tutorial_rng = {};
+		tutorial_rng.seed(10032);
+		the_deck.cards = CreateDeck(5, 5, 5);
+
+		auto deck_copy = the_deck.cards;
+		//shuffle(std::begin(the_deck), std::end(the_deck), tutorial_rng);
+
+		//std::vector<int> indices;
+
+		//for (int i = 0; i < 7; i++) {
+		//	auto loc = std::find(std::begin(deck_copy), std::end(deck_copy), the_deck[the_deck.size() - i - 1]);
+		//	indices.push_back(loc - std::begin(deck_copy));
+		//}
+
+		//// Draw the cards into the tutorial hand
+		//int cards_to_draw = std::min(hand.max_size - hand.cards.size(), the_deck.size());
+
+		//for (int i = 0; i < cards_to_draw; i++) {
+		//	hand.Add(the_deck.back());
+		//	the_deck.pop_back();
+		//}
+
+		// Shuffling is not stable across platforms.  This normally doesn't matter but the tutorial
+		// needs specific cards for the examples.
+		std::array<int, 7> hand_card_indices = {59, 91, 24, 54, 36, 90, 109};
+		for (const auto& index : hand_card_indices) {
+			hand.Add(*(std::begin(the_deck.cards) + index));
+		}
+		
+		std::sort(std::begin(hand_card_indices), std::end(hand_card_indices), std::greater<int>());
+		for (const auto& index : hand_card_indices) {
+			the_deck.cards.erase(std::begin(the_deck.cards) + index);
+		}
+
+		// Shuffle the deck now just in case it is needed
+		RUN_TRACE_SCOPE("Shuffle");
+		the_deck.Shuffle(tutorial_rng);
+
+		in_play.Add(hand.cards[0]);
+		hand.cards.erase(std::begin(hand.cards));
+
+		tutorial_id = 0;
+	}
+
+	GameState OnUserUpdate(float fElapsedTime) override {
+		GameState next_state = GameState::TUTORIAL;
+		const auto& td = tutorial_data[tutorial_id];
+		screen_cache.Draw(pge, this, tutorial_id, [&] {
+			if (td.draw_in_play) {
+				in_play.Draw(pge);
+			}
+
+			if (td.draw_hand) {
+				hand.Draw(pge);
+			}
+
+			if (td.draw_color_track) {
+				DrawColorPanel(pge, { 128.0f, 193.0f });
+			}
+
+			if (td.draw_end_turn) {
+				olc::vf2d button_pos = { 2.0f, 193.0f };
+				olc::vf2d button_size = { 80.0f, 10.0f };
+
+				pge->FillRectDecal(button_pos, button_size, olc::DARK_GREY);
+
+				constexpr olc::vf2d text_size = olc::TextSize("End Turn");
+				olc::vf2d scale = (button_size) / text_size;
+
+				pge->DrawStringDecal(button_pos + olc::vf2d{ 0.5f, 0.5f }, "End Turn", olc::BLACK, scale);
+			}
+
+			if (td.draw_discard) {
+				olc::vf2d button_pos = { 174.0f, 193.0f };
+				olc::vf2d button_size = { 80.0f, 10.0f };
+
+				pge->FillRectDecal(button_pos, button_size, olc::DARK_GREY);
+
+				constexpr olc::vf2d text_size = olc::TextSize("Discard");
+				olc::vf2d scale = (button_size) / text_size;
+
+				pge->DrawStringDecal(button_pos + olc::vf2d{ 0.5f, 0.5f }, "Discard", olc::BLACK, scale);
+			}
+
+			for (const auto& rect : td.rects) {
+				pge->DrawRectDecal(rect.pos, rect.size, rect.color);
+			}
+
+			for (const auto& line : td.lines) {
+				pge->DrawLineDecal(line.pos_a, line.pos_b, line.color);
+			}
+
+			for (const auto& text : td.text) {
+				pge->DrawStringDecal(text.pos, text.str, text.color);
+			}
+		});
+
+		if (pge->GetMouse(0).bPressed) {
+			if (tutorial_id < tutorial_data.size() - 1) {
+				tutorial_id++;
+				if (tutorial_id == 3) {
+					in_play.Add(hand.cards[0]);
+					hand.cards.erase(std::begin(hand.cards));
+					in_play.Add(hand.cards[0]);
+					hand.cards.erase(std::begin(hand.cards));
+				}
+			}
+			else {
+				next_state = GameState::START_SCREEN;
+			}
+		}
+
+		return next_state;
+	}
+};
+
+// PickCardState for the attract mode bot, which picks the greedy move after
+// pretending to think for a moment
+struct AttractPickState : public State {
+	AttractPickState(olc::PixelGameEngine* pge) : State(pge) {};
+
+	const float think_time = 0.6f;
+	float fThinking = 0.0f;
+	TranspositionTable table{ 1 << 20 };
+
+	void EnterState() override {
+		fThinking = 0.0f;
+	}
+
+	GameState OnUserUpdate(float fElapsedTime) override {
+		GameState next_state = GameState::PICK_CARD;
+
+		DrawEndButton(pge, in_play.cards.size() > 2);
+		DrawDiscardButton(pge);
+
+		fThinking += fElapsedTime;
+		if (fThinking >= think_time) {
+			int action = search::GreedyAction(SnapshotGame(), table);
+			if (action >= sim::PLAY_0 && action < sim::PLAY_0 + int(hand.cards.size())) {
+				card_played_index = action - sim::PLAY_0;
+				next_state = GameState::ANIMATE_PLAY;
+			}
+			else if (action == sim::END_TURN) {
+				next_state = GameState::END_TURN;
+			}
+			else {
+				DiscardHand();
+				next_state = GameState::END_TURN;
+			}
+		}
+
+		DrawNormalInterface(pge);
+
+		return next_state;
+	}
+};
+
+// Whole games played by a bot behind the title screen once the player has
+// left it alone for a while.  The normal game states run on a GameContext of
+// their own, swapped in only for the attract frames, so the player's game is
+// never touched and starting one needs no cleanup.  Any mouse activity stops
+// it before the bot's states get to see the input.
+struct AttractMode {
+	const float idle_time = 15.0f;
+	const float speed = 3.0f;         // game time per real second
+	const float final_score_time = 2.0f;
+
+	std::map<GameState, std::unique_ptr<State>> states;
+	GameContext context;
+	GameState current_state = GameState::GAME_START;
+	GameState prev_state = GameState::NONE;
+	float fIdle = 0.0f;
+	float fEnded = 0.0f;
+	olc::vi2d last_mouse;
+
+	explicit AttractMode(olc::PixelGameEngine* pge) {
+		states.insert(std::make_pair(GameState::GAME_START, std::make_unique<GameStartState>(pge)));
+		states.insert(std::make_pair(GameState::DRAW_CARDS, std::make_unique<DrawCardsState>(pge)));
+		states.insert(std::make_pair(GameState::PICK_CARD, std::make_unique<AttractPickState>(pge)));
+		states.insert(std::make_pair(GameState::END_TURN, std::make_unique<EndTurnState>(pge)));
+		states.insert(std::make_pair(GameState::END_GAME, std::make_unique<EndGameState>(pge)));
+		states.insert(std::make_pair(GameState::ANIMATE_PLAY, std::make_unique<PlayCardAnimationState>(pge)));
+		states.insert(std::make_pair(GameState::ANIMATE_UNPLAY, std::make_unique<UnPlayCardAnimationState>(pge)));
+	}
+
+	bool Running() const {
+		return fIdle >= idle_time;
+	}
+
+	void Stop() {
+		fIdle = 0.0f;
+	}
+
+	// Plays one frame of the attract game if the player has been idle long
+	// enough, returns whether it drew anything
+	bool Update(olc::PixelGameEngine* pge, float fElapsedTime) {
+		bool active = pge->GetMousePos() != last_mouse || pge->GetMouse(0).bPressed || pge->GetMouse(0).bHeld;
+		last_mouse = pge->GetMousePos();
+		if (active) {
+			Stop();
+			return false;
+		}
+
+		fIdle += fElapsedTime;
+		if (!Running()) {
+			return false;
+		}
+		if (prev_state == GameState::NONE) {
+			// Seeded only once it first runs, so scripted runs that never idle
+			// see the same rng as before
+			context.rng.seed(rng());
+		}
+
+		context.Swap();
+		float step = speed * fElapsedTime;
+		const auto& state = states.at(current_state);
+		if (current_state != prev_state) {
+			state->EnterState();
+		}
+		GameState next_state = state->OnUserUpdate(step);
+
+		// Show the final score for a moment, then deal the next game
+		if (current_state == GameState::END_GAME) {
+			fEnded += step;
+			next_state = fEnded >= final_score_time ? GameState::GAME_START : GameState::END_GAME;
+			score = next_state == GameState::GAME_START ? 0 : score;
+		}
+		if (next_state != current_state) {
+			state->ExitState();
+			fEnded = 0.0f;
+		}
+		prev_state = current_state;
+		current_state = next_state;
+		context.Swap();
+
+		// Keep the title readable on top
+		pge->FillRectDecal({ 0.0f, 0.0f }, olc::vf2d(pge->GetScreenSize()), olc::Pixel(0, 0, 0, 160));
+		return true;
+	}
+};
+
+inline std::map<GameState, std::unique_ptr<State>> gameStates;
+
+
+class Run : public olc::PixelGameEngine
+{
+public:
+	Run()
+	{
+		sAppName = "Run";
+
+	}
+	GameState current_state = GameState::START_SCREEN;
+	GameState next_state = GameState::START_SCREEN;
+	GameState prev_state = GameState::NONE;
+
+public:
+	bool OnUserCreate() override
+	{
+		gameStates.insert(std::make_pair(GameState::START_SCREEN, std::make_unique<StartScreenState>(this)));
+		gameStates.insert(std::make_pair(GameState::GAME_START, std::make_unique<GameStartState>(this)));
+		gameStates.insert(std::make_pair(GameState::DRAW_CARDS, std::make_unique<DrawCardsState>(this)));
+		gameStates.insert(std::make_pair(GameState::PICK_CARD, std::make_unique<PickCardState>(this)));
+		gameStates.insert(std::make_pair(GameState::END_GAME, std::make_unique<EndGameState>(this)));
+		gameStates.insert(std::make_pair(GameState::ANIMATE_PLAY, std::make_unique<PlayCardAnimationState>(this)));
+		gameStates.insert(std::make_pair(GameState::ANIMATE_UNPLAY, std::make_unique<UnPlayCardAnimationState>(this)));
+		gameStates.insert(std::make_pair(GameState::LENGTH_SELECT, std::make_unique<LengthSelectState>(this)));
+		gameStates.insert(std::make_pair(GameState::END_TURN, std::make_unique<EndTurnState>(this)));
+		gameStates.insert(std::make_pair(GameState::TUTORIAL, std::make_unique<TutorialState>(this)));
+
+		InitializeCards();
+		attract = std::make_unique<AttractMode>(this);
+
+		return true;
+	}
+
+	int side_count = 3;
+	int deck_index = 0;
+
+	// When non-zero every frame advances by exactly this many seconds, so
+	// scripted runs animate identically regardless of how long frames take
+	float fixed_time_step = 0.0f;
+
+	// F1 toggles a table of heap allocations per frame, split by game state
+	bool show_alloc_stats = false;
+	std::string alloc_stats_text;
+
+	// H toggles the hint, searched in the background while picking cards
+	bool show_hint = false;
+	HintSearch hint;
+
+	std::unique_ptr<AttractMode> attract;
+
+	void DrawAllocStats()
+	{
+#if defined(RUN_ALLOC_STATS)
+		// Built into a buffer that keeps its capacity so the overlay does not
+		// show up in its own numbers
+		char line[64];
+		alloc_stats_text.clear();
+
+		auto last = alloc_stats::LastFrame();
+		std::snprintf(line, sizeof(line), "Last frame %llu allocs %llu B\n\n", (unsigned long long)last.count, (unsigned long long)last.bytes);
+		alloc_stats_text += line;
+		alloc_stats_text += "State          avg  peak\n";
+
+		for (int tag = int(GameState::START_SCREEN); tag <= int(GameState::TUTORIAL); tag++) {
+			const auto& s = alloc_stats::StatsFor(tag);
+			if (s.frames == 0) {
+				continue;
+			}
+			std::snprintf(line, sizeof(line), "%-14.14s %4.1f %5llu\n", GameStateName(GameState(tag)),
+				double(s.total.count) / double(s.frames), (unsigned long long)s.peak.count);
+			alloc_stats_text += line;
+		}
+#else
+		alloc_stats_text = "Define RUN_ALLOC_STATS\nto count allocations";
+#endif
+		FillRectDecal({ 4.0f, 40.0f }, { 248.0f, 130.0f }, olc::Pixel(0, 0, 0, 200));
+		DrawStringDecal({ 8.0f, 44.0f }, alloc_stats_text, olc::YELLOW);
+	}
+
+	bool OnUserUpdate(float fElapsedTime) override
+	{
+		alloc_stats::NextFrame(int(current_state));
+
+		if (fixed_time_step > 0.0f) {
+			fElapsedTime = fixed_time_step;
+		}
+
+		fTotalTime += fElapsedTime;
+		const auto& state = gameStates.at(current_state);
+		hint_card = show_hint ? hint.Card() : -1;
+
+		// The title has to be drawn over the attract game rather than under it
+		if (current_state == GameState::START_SCREEN) {
+			screen_cache.immediate = attract->Update(this, fElapsedTime);
+		}
+		else {
+			attract->Stop();
+			screen_cache.immediate = false;
+		}
+
+		if (current_state != prev_state) {
+			RUN_TRACE_INSTANT(GameStateName(current_state));
+			RUN_TRACE_SCOPE("EnterState");
+			if (current_state != GameState::PICK_CARD) {
+				pending_press.reset();
+			}
+			state->EnterState();
+		}
+
+		{
+			RUN_TRACE_SCOPE(GameStateName(current_state));
+			next_state = state->OnUserUpdate(fElapsedTime);
+		}
+
+		if (next_state != current_state) {
+			RUN_TRACE_SCOPE("ExitState");
+			state->ExitState();
+		}
+
+		screen_cache.EndFrame(this);
+
+		prev_state = current_state;
+		current_state = next_state;
+
+		// Restart the hint whenever the player gets to pick from a new position,
+		// playing or taking back a card cancels it until the animation is done
+		if (GetKey(olc::Key::H).bPressed) {
+			show_hint = !show_hint;
+			if (show_hint && current_state == GameState::PICK_CARD) {
+				hint.Start(SnapshotGame());
+			}
+			else {
+				hint.Cancel();
+			}
+		}
+		else if (show_hint && current_state != prev_state) {
+			if (current_state == GameState::PICK_CARD) {
+				hint.Start(SnapshotGame());
+			}
+			else if (prev_state == GameState::PICK_CARD) {
+				hint.Cancel();
+			}
+		}
+
+		// Dump the trace on demand, it is also written when the game closes
+		if (GetKey(olc::Key::F9).bPressed) {
+			RUN_TRACE_DUMP("run_trace.json");
+		}
+
+		if (GetKey(olc::Key::F1).bPressed) {
+			show_alloc_stats = !show_alloc_stats;
+			alloc_stats_text.reserve(512);
+		}
+		if (show_alloc_stats) {
+			DrawAllocStats();
+		}
+
+		return true;
+	}
+
+	bool OnUserDestroy() override {
+		RUN_TRACE_DUMP("run_trace.json");
+		return true;
+	}
+};
@@ -0,0 +1,101 @@
+// Batched headless games behind the C interface in RunEnv.h.
+
+#define RUN_ENV_BUILD
+#include "RunEnv.h"
+#include "Sim.h"
+
+#include <memory>
+#include <new>
+
+static_assert(int(RUN_ENV_ACTION_END_TURN) == int(sim::END_TURN), "action numbering must match sim::Action");
+static_assert(int(RUN_ENV_ACTION_DISCARD) == int(sim::DISCARD), "action numbering must match sim::Action");
+static_assert(int(RUN_ENV_ACTION_UNPLAY) == int(sim::UNPLAY), "action numbering must match sim::Action");
+static_assert(int(RUN_ENV_ACTION_COUNT) == int(sim::ACTION_COUNT), "action numbering must match sim::Action");
+static_assert(RUN_ENV_OBS_LAST_PLAYED - RUN_ENV_OBS_HAND == sim::hand_limit, "one observation slot per card in hand");
+
+struct run_env {
+	int32_t num_envs;
+	int32_t game_length;
+	std::unique_ptr<sim::Game[]> games;
+};
+
+namespace {
+	void Observe(const sim::Game& game, int32_t* obs) {
+		for (int i = 0; i < sim::hand_limit; i++) {
+			obs[RUN_ENV_OBS_HAND + i] = i < game.hand_size ? sim::CardId(game.hand[i], game.game_length) : -1;
+		}
+		obs[RUN_ENV_OBS_LAST_PLAYED] = game.in_play_size > 0 ? sim::CardId(game.in_play[game.in_play_size - 1], game.game_length) : -1;
+		obs[RUN_ENV_OBS_RUN_LENGTH] = game.in_play_size;
+		obs[RUN_ENV_OBS_RULES] = int32_t(game.rules);
+		obs[RUN_ENV_OBS_DECK_COUNT] = game.deck_size;
+		obs[RUN_ENV_OBS_SCORE] = game.score;
+		obs[RUN_ENV_OBS_ACTION_MASK] = int32_t(game.ActionMask());
+	}
+}
+
+run_env* run_env_create(int32_t num_envs, int32_t game_length) {
+	if (num_envs <= 0 || game_length < 1 || game_length > sim::max_game_length) {
+		return nullptr;
+	}
+
+	auto env = new (std::nothrow) run_env;
+	if (env == nullptr) {
+		return nullptr;
+	}
+	env->num_envs = num_envs;
+	env->game_length = game_length;
+	env->games.reset(new (std::nothrow) sim::Game[num_envs]);
+	if (!env->games) {
+		delete env;
+		return nullptr;
+	}
+
+	for (int32_t i = 0; i < num_envs; i++) {
+		env->games[i].Reset(uint32_t(i), game_length);
+	}
+	return env;
+}
+
+void run_env_destroy(run_env* env) {
+	delete env;
+}
+
+int32_t run_env_num_envs(const run_env* env) {
+	return env->num_envs;
+}
+
+void run_env_reset(run_env* env, const uint32_t* seeds, int32_t* obs) {
+	for (int32_t i = 0; i < env->num_envs; i++) {
+		env->games[i].Reset(seeds[i], env->game_length);
+		Observe(env->games[i], obs + i * RUN_ENV_OBS_SIZE);
+	}
+}
+
+void run_env_step(run_env* env, const int32_t* actions, int32_t* obs, float* rewards, uint8_t* dones) {
+	for (int32_t i = 0; i < env->num_envs; i++) {
+		sim::Game& game = env->games[i];
+
+		if (game.over) {
+			game.Reset(uint32_t(game.rng()), env->game_length);
+			rewards[i] = 0.0f;
+		}
+		else {
+			rewards[i] = float(game.Step(actions[i]));
+		}
+
+		dones[i] = game.over ? 1 : 0;
+		Observe(game, obs + i * RUN_ENV_OBS_SIZE);
+	}
+}
+
+int32_t run_env_card(const run_env* env, int32_t card_id, int32_t* features) {
+	if (card_id < 0 || card_id >= env->game_length * env->game_length * env->game_length) {
+		return -1;
+	}
+	sim::Card c = sim::MakeCard(card_id, env->game_length);
+	features[0] = c.number;
+	features[1] = c.letter;
+	features[2] = c.sides;
+	features[3] = c.color;
+	return 0;
+}
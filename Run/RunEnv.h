@@ -0,0 +1,81 @@
+#ifndef RUN_ENV_H
+#define RUN_ENV_H
+
+/* C interface to a batch of headless Run games for training agents.
+ *
+ * Every game is a sim::Game (see Sim.h) so the rules are the ones the real
+ * game uses.  All memory is allocated by run_env_create; reset and step only
+ * write into the buffers passed in, laid out one row per game:
+ *
+ *   obs      int32_t[num_envs * RUN_ENV_OBS_SIZE]
+ *   rewards  float[num_envs]          points scored by the action
+ *   dones    uint8_t[num_envs]        1 when the game ended on this step
+ *
+ * A game that has ended is reset by its next step with a seed drawn from its
+ * own rng, and that step reports the first observation of the new game with
+ * a reward of 0, so a fixed set of seeds always replays identically.
+ *
+ * Build as a shared library (from the repository root):
+ *   g++ -std=c++17 -O2 -shared -fPIC Run/RunEnv.cpp -o librunenv.so
+ *   cl /std:c++17 /O2 /EHsc /LD Run\RunEnv.cpp /Fe:runenv.dll
+ *
+ * and, for example, from Python:
+ *   env = ctypes.CDLL("./librunenv.so").run_env_create(4096, 5)
+ */
+
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(RUN_ENV_BUILD)
+#define RUN_ENV_API __declspec(dllexport)
+#elif defined(_WIN32)
+#define RUN_ENV_API __declspec(dllimport)
+#else
+#define RUN_ENV_API __attribute__((visibility("default")))
+#endif
+
+/* Observation fields.  Cards are ids in deck order (see run_env_card) or -1. */
+enum {
+	RUN_ENV_OBS_HAND = 0,         /* 7 cards in hand */
+	RUN_ENV_OBS_LAST_PLAYED = 7,  /* the card the next one must follow */
+	RUN_ENV_OBS_RUN_LENGTH = 8,   /* cards in the current run */
+	RUN_ENV_OBS_RULES = 9,        /* enabled rules, bit n is sim::RuleBit n */
+	RUN_ENV_OBS_DECK_COUNT = 10,
+	RUN_ENV_OBS_SCORE = 11,
+	RUN_ENV_OBS_ACTION_MASK = 12, /* bit n set when action n is allowed */
+	RUN_ENV_OBS_SIZE = 13
+};
+
+/* Actions 0 to 6 play that card from the hand */
+enum {
+	RUN_ENV_ACTION_END_TURN = 7,
+	RUN_ENV_ACTION_DISCARD = 8,
+	RUN_ENV_ACTION_UNPLAY = 9,
+	RUN_ENV_ACTION_COUNT = 10
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct run_env run_env;
+
+/* game_length is 5 (Normal) to 9 (Too Long).  Returns NULL on bad arguments. */
+RUN_ENV_API run_env* run_env_create(int32_t num_envs, int32_t game_length);
+RUN_ENV_API void run_env_destroy(run_env* env);
+RUN_ENV_API int32_t run_env_num_envs(const run_env* env);
+
+/* Starts every game over with the given seeds */
+RUN_ENV_API void run_env_reset(run_env* env, const uint32_t* seeds, int32_t* obs);
+
+/* Applies one action per game.  Actions that are not allowed are ignored. */
+RUN_ENV_API void run_env_step(run_env* env, const int32_t* actions, int32_t* obs, float* rewards, uint8_t* dones);
+
+/* Writes number (1 based), letter (0 for A), sides and color index of a card id.
+ * Returns 0, or -1 without writing anything if card_id is not in this deck. */
+RUN_ENV_API int32_t run_env_card(const run_env* env, int32_t card_id, int32_t* features);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
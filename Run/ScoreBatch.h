@@ -0,0 +1,165 @@
+#pragma once
+
+// Scores many runs in one call, for searches that weigh thousands of
+// candidate runs per move.
+//
+// Runs are given attribute by attribute: run r is cards offsets[r] to
+// offsets[r + 1] of the numbers, letters, sides and colors arrays.  For
+// runs of up to 16 cards the count of each value is found with SIMD instead
+// of a histogram: every card's attribute is compared against the broadcast
+// attribute of each card in the run and the matches added up lane by lane,
+// so lane i ends up holding how many cards share card i's value.  The
+// largest lane is the "most common value" the bonus is built from.  Longer
+// runs, and builds without SSE2 or WebAssembly SIMD, use sim::ScoreCounter.
+//
+//	sim::RunBatch batch;
+//	batch.Add(run.data(), run.size());
+//	std::vector<int> scores(batch.Runs());
+//	sim::ScoreBatch(batch, rules, scores.data());
+
+#include "Sim.h"
+
+#include <vector>
+
+#if defined(RUN_SIM_SSE2) || defined(RUN_SIM_AVX2)
+#include <emmintrin.h>
+#endif
+
+namespace sim {
+	struct RunBatch {
+		// Every attribute array has this many bytes past the last card, so a run
+		// can always be loaded 16 cards at a time
+		static constexpr size_t padding = 16;
+
+		std::vector<uint32_t> offsets{ 0 };
+		std::vector<int8_t> numbers = std::vector<int8_t>(padding);
+		std::vector<int8_t> letters = std::vector<int8_t>(padding);
+		std::vector<int8_t> sides = std::vector<int8_t>(padding);
+		std::vector<int8_t> colors = std::vector<int8_t>(padding);
+
+		size_t Runs() const { return offsets.size() - 1; }
+		size_t Cards() const { return offsets.back(); }
+
+		void Clear() {
+			offsets.assign(1, 0);
+			for (auto* lane : { &numbers, &letters, &sides, &colors }) {
+				lane->assign(padding, 0);
+			}
+		}
+
+		void Add(const Card* run, size_t count) {
+			size_t at = Cards();
+			for (auto* lane : { &numbers, &letters, &sides, &colors }) {
+				lane->resize(at + count + padding, 0);
+			}
+			for (size_t i = 0; i < count; i++) {
+				numbers[at + i] = run[i].number;
+				letters[at + i] = run[i].letter;
+				sides[at + i] = run[i].sides;
+				colors[at + i] = run[i].color;
+			}
+			offsets.push_back(uint32_t(at + count));
+		}
+	};
+
+	namespace detail {
+		inline int FibOf(int length) {
+			static const std::array<int, 64> table = [] {
+				std::array<int, 64> t{};
+				for (int i = 0; i < int(t.size()); i++) {
+					t[i] = Fib(i);
+				}
+				return t;
+			}();
+			return length < int(table.size()) ? table[length] : Fib(length);
+		}
+
+		// How many cards share the most common value of one attribute, for runs
+		// of 1 to 16 cards
+#if defined(RUN_SIM_SSE2) || defined(RUN_SIM_AVX2)
+		inline int MostCommon(const int8_t* values, int length) {
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+			__m128i counts = _mm_setzero_si128();
+			for (int j = 0; j < length; j++) {
+				// Matches are -1, so subtracting them counts up
+				counts = _mm_sub_epi8(counts, _mm_cmpeq_epi8(v, _mm_set1_epi8(values[j])));
+			}
+			// Lanes past the run may hold the next run's cards
+			alignas(16) static constexpr int8_t lane_index[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+			__m128i in_run = _mm_cmplt_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(lane_index)), _mm_set1_epi8(int8_t(length)));
+			counts = _mm_and_si128(counts, in_run);
+
+			counts = _mm_max_epu8(counts, _mm_srli_si128(counts, 8));
+			counts = _mm_max_epu8(counts, _mm_srli_si128(counts, 4));
+			counts = _mm_max_epu8(counts, _mm_srli_si128(counts, 2));
+			counts = _mm_max_epu8(counts, _mm_srli_si128(counts, 1));
+			return _mm_cvtsi128_si32(counts) & 0xFF;
+		}
+#define RUN_SCORE_BATCH_SIMD
+#elif defined(RUN_SIM_WASM_SIMD)
+		inline int MostCommon(const int8_t* values, int length) {
+			v128_t v = wasm_v128_load(values);
+			v128_t counts = wasm_i8x16_splat(0);
+			for (int j = 0; j < length; j++) {
+				counts = wasm_i8x16_sub(counts, wasm_i8x16_eq(v, wasm_i8x16_splat(values[j])));
+			}
+			v128_t lane_index = wasm_i8x16_make(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+			counts = wasm_v128_and(counts, wasm_i8x16_lt(lane_index, wasm_i8x16_splat(int8_t(length))));
+
+			counts = wasm_u8x16_max(counts, wasm_i8x16_shuffle(counts, counts, 8, 9, 10, 11, 12, 13, 14, 15, 0, 0, 0, 0, 0, 0, 0, 0));
+			counts = wasm_u8x16_max(counts, wasm_i8x16_shuffle(counts, counts, 4, 5, 6, 7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0));
+			counts = wasm_u8x16_max(counts, wasm_i8x16_shuffle(counts, counts, 2, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0));
+			counts = wasm_u8x16_max(counts, wasm_i8x16_shuffle(counts, counts, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0));
+			return wasm_u8x16_extract_lane(counts, 0);
+		}
+#define RUN_SCORE_BATCH_SIMD
+#endif
+	}
+
+	// Writes the score of every run in batch to scores[0, batch.Runs()), the
+	// same values Score gives for each run on its own
+	inline void ScoreBatch(const RunBatch& batch, uint32_t rules, int* scores) {
+		auto times = [rules](RuleBit rule) { return (rules & Bit(rule)) ? 2 : 1; };
+		const int length_times = times(DOUBLE_LENGTH);
+		const int number_times = times(DOUBLE_NUMBER);
+		const int letter_times = times(DOUBLE_LETTER);
+		const int sides_times = times(DOUBLE_SHAPE);
+		const int color_times = times(DOUBLE_COLOR);
+
+		for (size_t r = 0; r < batch.Runs(); r++) {
+			uint32_t first = batch.offsets[r];
+			int length = int(batch.offsets[r + 1] - first);
+			if (length == 0) {
+				scores[r] = 0;
+				continue;
+			}
+
+			int most_numbers, most_letters, most_sides, most_colors;
+#if defined(RUN_SCORE_BATCH_SIMD)
+			if (length <= 16) {
+				most_numbers = detail::MostCommon(&batch.numbers[first], length);
+				most_letters = detail::MostCommon(&batch.letters[first], length);
+				most_sides = detail::MostCommon(&batch.sides[first], length);
+				most_colors = detail::MostCommon(&batch.colors[first], length);
+			}
+			else
+#endif
+			{
+				ScoreCounter counter;
+				for (int i = 0; i < length; i++) {
+					counter.Add({ batch.numbers[first + i], batch.letters[first + i], batch.sides[first + i], batch.colors[first + i] });
+				}
+				most_numbers = counter.most_numbers;
+				most_letters = counter.most_letters;
+				most_sides = counter.most_sides;
+				most_colors = counter.most_colors;
+			}
+
+			scores[r] = detail::FibOf(length) * length_times
+				+ (most_numbers - 1) * number_times
+				+ (most_sides - 1) * sides_times
+				+ (most_letters - 1) * letter_times
+				+ (most_colors - 1) * color_times;
+		}
+	}
+}
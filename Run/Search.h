@@ -0,0 +1,306 @@
+#pragma once
+
+// Players built on sim::Game that cache what they work out in a shared
+// TranspositionTable, so the work is reused from one move to the next and
+// between threads searching the same game.
+//
+//	BestRun        the highest scoring run that can be finished this turn
+//	RolloutValue   expected points still to come, by playing the game out
+//	ActionValue    the same after taking a given action first
+//	RolloutAction  the action with the best ActionValue
+//	EnumerateTurns every different way to finish the turn, for turn level searches
+//
+// Both kinds of entry can share one table; their keys are salted apart.
+
+#include "Sim.h"
+#include "Transposition.h"
+
+#include <vector>
+
+namespace search {
+	constexpr uint64_t best_run_salt = 0x5F1E3A7C9B2D4E61ull;
+	constexpr uint64_t rollout_salt = 0xA3C59AC2F81B6D07ull;
+
+	struct RunChoice {
+		int score = -1;          // -1 when no run of 3 can be finished
+		int action = sim::DISCARD; // first action towards it
+	};
+
+	namespace detail {
+		struct RunNode {
+			sim::HandLanes hand;
+			int hand_size = 0;
+			sim::Card last{};
+			bool has_last = false;
+			sim::ScoreCounter counter;
+			uint64_t key = 0;
+		};
+
+		inline RunChoice SearchRun(const RunNode& node, uint32_t rules, TranspositionTable& table) {
+			TranspositionTable::Entry entry;
+			if (table.Probe(node.key, entry)) {
+				return { int(entry.value), int(entry.move) };
+			}
+
+			RunChoice best;
+			if (node.counter.length > 2) {
+				best = { node.counter.Total(rules), sim::END_TURN };
+			}
+
+			uint32_t playable = node.has_last ? sim::PlayableMask(node.last, node.hand, node.hand_size, rules) : (1u << node.hand_size) - 1;
+			for (int i = 0; i < node.hand_size; i++) {
+				const sim::Card& c = node.hand[i];
+				if (!(playable & (1u << i))) {
+					continue;
+				}
+
+				RunNode child = node;
+				std::copy(node.hand.begin() + i + 1, node.hand.begin() + node.hand_size, child.hand.begin() + i);
+				child.hand_size--;
+				child.key ^= sim::zobrist::Hand(c) ^ sim::zobrist::Run(c) ^ sim::zobrist::Last(c);
+				child.key ^= node.has_last ? sim::zobrist::Last(node.last) : 0;
+				child.last = c;
+				child.has_last = true;
+				child.counter.Add(c);
+
+				int score = SearchRun(child, rules, table).score;
+				if (score > best.score) {
+					best = { score, sim::PLAY_0 + i };
+				}
+			}
+
+			table.Store(node.key, { float(best.score), uint8_t(node.hand_size + 1), TranspositionTable::EXACT, uint8_t(best.action) });
+			return best;
+		}
+	}
+
+	// The best run that can be ended this turn from the hand and the cards
+	// already played.  Only the rules that change validity and scoring are
+	// part of the key, those cannot change part way through a turn.
+	inline RunChoice BestRun(const sim::Game& game, TranspositionTable& table) {
+		// The same cards in a different order must give the same cached action
+		auto id = [](const sim::Card& c) { return sim::CardId(c, sim::max_game_length); };
+		detail::RunNode node;
+		node.hand = game.hand;
+		node.hand_size = game.hand_size;
+		std::sort(node.hand.begin(), node.hand.begin() + node.hand_size, [&](const sim::Card& a, const sim::Card& b) { return id(a) < id(b); });
+		node.key = best_run_salt;
+		for (int i = 0; i < game.hand_size; i++) {
+			node.key ^= sim::zobrist::Hand(game.hand[i]);
+		}
+		for (int i = 0; i < game.in_play_size; i++) {
+			node.counter.Add(game.in_play[i]);
+			node.key ^= sim::zobrist::Run(game.in_play[i]);
+		}
+		if (game.in_play_size > 0) {
+			node.last = game.in_play[game.in_play_size - 1];
+			node.has_last = true;
+			node.key ^= sim::zobrist::Last(node.last);
+		}
+		for (int r = 0; r < int(sim::RULE_COUNT); r++) {
+			node.key ^= (game.rules & (1u << r)) ? sim::zobrist::Rule(r, 0) : 0;
+		}
+
+		RunChoice best = detail::SearchRun(node, game.rules, table);
+		if (best.action >= sim::PLAY_0 && best.action < sim::PLAY_0 + sim::hand_limit) {
+			const sim::Card& c = node.hand[best.action - sim::PLAY_0];
+			for (int i = 0; i < game.hand_size; i++) {
+				if (id(game.hand[i]) == id(c)) {
+					best.action = sim::PLAY_0 + i;
+				}
+			}
+		}
+		return best;
+	}
+
+	// Plays the best run each turn and discards when there is none
+	inline int GreedyAction(const sim::Game& game, TranspositionTable& table) {
+		RunChoice run = BestRun(game, table);
+		return run.score >= 0 ? run.action : sim::DISCARD;
+	}
+
+	// One way to finish the turn from where the game is: the hand cards played
+	// (by bit) in a legal order, then either ending the turn or discarding the
+	// rest of the hand.  points is left for the caller to fill in.
+	struct Turn {
+		uint8_t mask = 0;
+		bool discard = false;
+		int8_t length = 0;
+		std::array<int8_t, sim::hand_limit> order{};
+		float points = 0.0f;
+	};
+
+	using Turns = std::array<Turn, (1 << sim::hand_limit) + 1>;
+
+	namespace detail {
+		struct TurnEnumerator {
+			const sim::Game& game;
+			Turns& turns;
+			int count = 0;
+			std::array<bool, 1 << sim::hand_limit> found{};
+			std::array<uint8_t, 1 << sim::hand_limit> expanded{}; // bit per last card already expanded
+			std::array<int8_t, sim::hand_limit> path{};
+
+			void Visit(uint8_t mask, int depth, int last) {
+				if (game.in_play_size + depth > 2 && !found[mask]) {
+					found[mask] = true;
+					Turn& t = turns[count++];
+					t = Turn{};
+					t.mask = mask;
+					t.length = int8_t(depth);
+					std::copy(path.begin(), path.begin() + depth, t.order.begin());
+				}
+
+				uint32_t playable = (1u << game.hand_size) - 1;
+				if (last >= 0 || game.in_play_size > 0) {
+					const sim::Card& prev = last >= 0 ? game.hand[last] : game.in_play[game.in_play_size - 1];
+					playable = sim::PlayableMask(prev, game.hand, game.hand_size, game.rules);
+				}
+				playable &= ~uint32_t(mask);
+
+				for (int i = 0; i < game.hand_size; i++) {
+					if (!(playable & (1u << i))) {
+						continue;
+					}
+					// What is left to play only depends on the cards used and the last one
+					uint8_t next = uint8_t(mask | (1u << i));
+					if (expanded[next] & (1u << i)) {
+						continue;
+					}
+					expanded[next] |= uint8_t(1u << i);
+
+					path[depth] = int8_t(i);
+					Visit(next, depth + 1, i);
+				}
+			}
+		};
+	}
+
+	// Every distinct set of hand cards that can finish the turn as a run,
+	// followed by discarding the hand as it is.  Returns how many were written.
+	// Rules can not change part way through a turn, so one legal order per set
+	// is enough.
+	inline int EnumerateTurns(const sim::Game& game, Turns& turns) {
+		detail::TurnEnumerator e{ game, turns };
+		e.Visit(0, 0, -1);
+
+		Turn& discard = turns[e.count];
+		discard = Turn{};
+		discard.discard = true;
+		return e.count + 1;
+	}
+
+	// The run the turn ends with, cards already in play included
+	inline sim::ScoreCounter TurnCounter(const sim::Game& game, const Turn& turn) {
+		sim::ScoreCounter counter;
+		for (int i = 0; i < game.in_play_size; i++) {
+			counter.Add(game.in_play[i]);
+		}
+		for (int n = 0; n < turn.length; n++) {
+			counter.Add(game.hand[turn.order[n]]);
+		}
+		return counter;
+	}
+
+	// The first action of the turn
+	inline int TurnAction(const Turn& turn) {
+		return turn.length > 0 ? sim::PLAY_0 + turn.order[0] : turn.discard ? sim::DISCARD : sim::END_TURN;
+	}
+
+	// Plays the whole turn and returns the points it scored.  The actions taken
+	// are appended to actions if one is given.
+	inline int ApplyTurn(sim::Game& game, const Turn& turn, std::vector<uint8_t>* actions = nullptr) {
+		// Hand indices shift down as earlier cards leave the hand
+		std::array<int8_t, sim::hand_limit> position;
+		for (int i = 0; i < sim::hand_limit; i++) {
+			position[i] = int8_t(i);
+		}
+		int points = 0;
+		for (int n = 0; n < turn.length; n++) {
+			int card = turn.order[n];
+			int action = sim::PLAY_0 + position[card];
+			points += game.Step(action);
+			if (actions) {
+				actions->push_back(uint8_t(action));
+			}
+			for (int i = card + 1; i < sim::hand_limit; i++) {
+				position[i]--;
+			}
+		}
+		int last = turn.discard || game.in_play_size < 3 ? sim::DISCARD : sim::END_TURN;
+		if (actions) {
+			actions->push_back(uint8_t(last));
+		}
+		return points + game.Step(last);
+	}
+
+	namespace detail {
+		// Plays first_action (if any) and then GreedyAction to the end of the
+		// game, on decks reshuffled from seed so the player does not peek at the
+		// real order.  The same seed gives the same decks whatever the action, so
+		// actions are compared on identical draws.
+		inline float Playout(const sim::Game& game, int first_action, int rollouts, uint32_t seed, TranspositionTable& table) {
+			std::mt19937 rng(seed);
+			sim::Game playout;
+			int total = 0;
+			for (int r = 0; r < rollouts; r++) {
+				playout = game;
+				playout.rng.seed(rng());
+				std::shuffle(playout.deck.begin(), playout.deck.begin() + playout.deck_size, rng);
+				if (first_action >= 0) {
+					total += playout.Step(first_action);
+				}
+				while (!playout.over) {
+					total += playout.Step(GreedyAction(playout, table));
+				}
+			}
+			return float(total) / float(std::max(rollouts, 1));
+		}
+
+		// Cached by game key and deck size; the deck's exact contents are not
+		// part of the key, so this is an estimate in more than one way
+		inline float CachedPlayout(const sim::Game& game, int first_action, int rollouts, uint32_t seed, TranspositionTable& table) {
+			uint64_t key = game.key ^ rollout_salt ^ sim::zobrist::SplitMix(uint64_t(game.deck_size) << 8 | uint64_t(first_action + 1));
+			uint8_t depth = uint8_t(std::min(rollouts, 255));
+
+			TranspositionTable::Entry entry;
+			if (table.Probe(key, entry) && entry.depth >= depth) {
+				return entry.value;
+			}
+
+			float value = Playout(game, first_action, rollouts, seed, table);
+			table.Store(key, { value, depth, TranspositionTable::EXACT, uint8_t(first_action + 1) });
+			return value;
+		}
+	}
+
+	// Average points still to be scored from here when playing GreedyAction
+	inline float RolloutValue(const sim::Game& game, int rollouts, uint32_t seed, TranspositionTable& table) {
+		return detail::CachedPlayout(game, -1, rollouts, seed, table);
+	}
+
+	// Average points from taking action here and playing GreedyAction after
+	inline float ActionValue(const sim::Game& game, int action, int rollouts, uint32_t seed, TranspositionTable& table) {
+		return detail::CachedPlayout(game, action, rollouts, seed, table);
+	}
+
+	// The legal action with the best ActionValue.  Unplaying only goes back to
+	// a position the last decision already weighed, so it is not considered.
+	inline int RolloutAction(const sim::Game& game, int rollouts, uint32_t seed, TranspositionTable& table) {
+		uint32_t mask = game.ActionMask() & ~(1u << sim::UNPLAY);
+		int best_action = sim::DISCARD;
+		float best_value = -1.0f;
+
+		for (int action = 0; action < sim::ACTION_COUNT; action++) {
+			if (!(mask & (1u << action))) {
+				continue;
+			}
+			float value = ActionValue(game, action, rollouts, seed, table);
+			if (value > best_value) {
+				best_value = value;
+				best_action = action;
+			}
+		}
+		return best_action;
+	}
+}
@@ -0,0 +1,558 @@
+#pragma once
+
+// The game rules without any rendering, animation or globals.
+//
+// Cards are four small integers and the enabled rules a bitmask, so a whole
+// game fits in one fixed size struct and can be stepped without touching the
+// heap.  IsValid and Score in Game.h forward to the kernels here, so the
+// interactive game, the tools and the training environment all play by the
+// same rules.
+//
+// Differences from the interactive game: there is no clock, so timed_turn
+// can be rolled and shows up in the rule mask but never ends a turn early.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string_view>
+
+// Define RUN_SIM_NO_SIMD to use the scalar PlayableMask everywhere
+#if defined(RUN_SIM_NO_SIMD)
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define RUN_SIM_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RUN_SIM_SSE2
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define RUN_SIM_WASM_SIMD
+#endif
+
+namespace sim {
+	// Rule bits in the order the rule map in Game.h iterates (alphabetical), so
+	// picking rule n at random means the same rule in both
+	enum RuleBit : uint32_t {
+		CARBON_COPY,
+		DISCARD_TO_DECK,
+		DOUBLE_COLOR,
+		DOUBLE_JUMP,
+		DOUBLE_LENGTH,
+		DOUBLE_LETTER,
+		DOUBLE_NUMBER,
+		DOUBLE_SHAPE,
+		MONOCHROME,
+		NO_UNPLAY,
+		RUN_BACKWARDS,
+		TIMED_TURN,
+		RULE_COUNT,
+	};
+
+	constexpr uint32_t Bit(RuleBit rule) {
+		return 1u << rule;
+	}
+
+	constexpr std::array<std::string_view, RULE_COUNT> rule_keys = {
+		"carbon_copy", "discard_to_deck", "double_color", "double_jump", "double_length", "double_letter",
+		"double_number", "double_shape", "monochrome", "no_unplay", "run_backwards", "timed_turn",
+	};
+
+	// Must match possible_rules in Game.h
+	struct RuleInfo {
+		int value;
+		bool tick_on_end;
+		bool tick_on_play;
+	};
+
+	constexpr std::array<RuleInfo, RULE_COUNT> rule_info = { {
+		{ 1, true, false }, // carbon_copy
+		{ 1, true, false }, // discard_to_deck
+		{ 2, true, false }, // double_color
+		{ 1, true, false }, // double_jump
+		{ 1, true, false }, // double_length
+		{ 2, true, false }, // double_letter
+		{ 2, true, false }, // double_number
+		{ 2, true, false }, // double_shape
+		{ 2, true, false }, // monochrome
+		{ 7, false, true }, // no_unplay
+		{ 3, true, false }, // run_backwards
+		{ 3, true, false }, // timed_turn
+	} };
+
+	// Returns RULE_COUNT for unknown keys
+	inline RuleBit RuleIndex(std::string_view key) {
+		for (uint32_t i = 0; i < RULE_COUNT; i++) {
+			if (rule_keys[i] == key) {
+				return RuleBit(i);
+			}
+		}
+		return RULE_COUNT;
+	}
+
+	struct Card {
+		int8_t number; // 1 based
+		int8_t letter; // 0 for 'A'
+		int8_t sides;  // 3 to 11
+		int8_t color;  // index into the color track
+	};
+
+	constexpr int color_count = 7;
+	constexpr int max_game_length = 9;
+	constexpr int max_deck_size = max_game_length * max_game_length * max_game_length;
+	constexpr int hand_limit = 7;
+
+	// Card ids follow the order CreateDeck builds the deck in
+	inline Card MakeCard(int id, int game_length) {
+		Card c;
+		c.sides = int8_t(id % game_length + 3);
+		c.letter = int8_t(id / game_length % game_length);
+		c.number = int8_t(id / (game_length * game_length) + 1);
+		c.color = int8_t(id % color_count);
+		return c;
+	}
+
+	inline int CardId(const Card& c, int game_length) {
+		return ((c.number - 1) * game_length + c.letter) * game_length + (c.sides - 3);
+	}
+
+	// Checks if the choice card would be valid if played after the end_card
+	inline bool IsValid(const Card& end_card, const Card& choice, uint32_t rules) {
+		int req_diff = 1;
+		req_diff *= (rules & Bit(RUN_BACKWARDS)) ? -1 : 1;
+		req_diff *= (rules & Bit(DOUBLE_JUMP)) ? 2 : 1;
+		req_diff *= (rules & Bit(CARBON_COPY)) ? 0 : 1;
+
+		bool valid = choice.letter == end_card.letter + req_diff
+			|| choice.number == end_card.number + req_diff
+			|| choice.sides == end_card.sides + req_diff;
+
+		// If monochrome is enabled color would only count if the required difference is also 0
+		if (rules & Bit(MONOCHROME)) {
+			return valid || req_diff == 0;
+		}
+		return valid || choice.color == end_card.color + req_diff;
+	}
+
+	// Cards are four bytes, so 8 of them make one 32 byte vector with the
+	// attributes in lanes: number, letter, sides, color, number, ...  Comparing
+	// it against the successor key (the attributes a valid next card could
+	// have, repeated in every card's lanes) tests every attribute of every card
+	// at once.  Hands are stored with room for 8 so they load straight into a
+	// register.
+	constexpr int mask_cards = 8;
+	using HandLanes = std::array<Card, mask_cards>;
+	static_assert(sizeof(HandLanes) == 32, "PlayableMask relies on four byte cards");
+
+	// Bit i set, for i < count, when cards[i] may be played after end_card; the
+	// same answer as IsValid for each card.  Uses AVX2, SSE2 or WebAssembly
+	// SIMD (build with -msimd128) when the compiler targets them.
+	inline uint32_t PlayableMask(const Card& end_card, const HandLanes& cards, int count, uint32_t rules) {
+		count = std::clamp(count, 0, mask_cards);
+		int req_diff = 1;
+		req_diff *= (rules & Bit(RUN_BACKWARDS)) ? -1 : 1;
+		req_diff *= (rules & Bit(DOUBLE_JUMP)) ? 2 : 1;
+		req_diff *= (rules & Bit(CARBON_COPY)) ? 0 : 1;
+
+		uint32_t all = (1u << count) - 1;
+		bool monochrome = (rules & Bit(MONOCHROME)) != 0;
+		if (monochrome && req_diff == 0) {
+			return all;
+		}
+
+		// Colors are never negative, so this lane can not match under monochrome
+		Card key = {
+			int8_t(end_card.number + req_diff),
+			int8_t(end_card.letter + req_diff),
+			int8_t(end_card.sides + req_diff),
+			monochrome ? int8_t(-128) : int8_t(end_card.color + req_diff),
+		};
+
+#if defined(RUN_SIM_AVX2) || defined(RUN_SIM_SSE2) || defined(RUN_SIM_WASM_SIMD)
+		int32_t key_bits;
+		std::memcpy(&key_bits, &key, sizeof(key_bits));
+		// A card matches when any byte of its 32 bit lane does, so compare the
+		// lanes with zero and take one sign bit per card
+#if defined(RUN_SIM_AVX2)
+		__m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(cards.data())), _mm256_set1_epi32(key_bits));
+		__m256i none = _mm256_cmpeq_epi32(eq, _mm256_setzero_si256());
+		uint32_t mask = ~uint32_t(_mm256_movemask_ps(_mm256_castsi256_ps(none)));
+#elif defined(RUN_SIM_SSE2)
+		__m128i k = _mm_set1_epi32(key_bits);
+		__m128i zero = _mm_setzero_si128();
+		__m128i lo = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(cards.data())), k);
+		__m128i hi = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(cards.data() + 4)), k);
+		uint32_t none = uint32_t(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(lo, zero))))
+			| uint32_t(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(hi, zero)))) << 4;
+		uint32_t mask = ~none;
+#else
+		v128_t k = wasm_i32x4_splat(key_bits);
+		v128_t lo = wasm_i8x16_eq(wasm_v128_load(cards.data()), k);
+		v128_t hi = wasm_i8x16_eq(wasm_v128_load(cards.data() + 4), k);
+		uint32_t mask = uint32_t(wasm_i32x4_bitmask(wasm_i32x4_ne(lo, wasm_i32x4_splat(0))))
+			| uint32_t(wasm_i32x4_bitmask(wasm_i32x4_ne(hi, wasm_i32x4_splat(0)))) << 4;
+#endif
+		return mask & all;
+#else
+		uint32_t mask = 0;
+		for (int i = 0; i < count; i++) {
+			const Card& c = cards[i];
+			bool valid = c.number == key.number || c.letter == key.letter || c.sides == key.sides || c.color == key.color;
+			mask |= valid ? 1u << i : 0u;
+		}
+		return mask & all;
+#endif
+	}
+
+	// The same for cards that are not already in a HandLanes
+	inline uint32_t PlayableMask(const Card& end_card, const Card* cards, int count, uint32_t rules) {
+		HandLanes lanes{};
+		std::copy(cards, cards + std::clamp(count, 0, mask_cards), lanes.begin());
+		return PlayableMask(end_card, lanes, count, rules);
+	}
+
+	inline int Fib(int x) {
+		return std::round(std::pow(1.618, x) / 2.236);
+	}
+
+	// Scores a run one card at a time.  A bonus is awarded for using many of
+	// the same number, letter, shape and color.
+	struct ScoreCounter {
+		std::array<uint16_t, 32> numbers{};
+		std::array<uint16_t, 32> letters{};
+		std::array<uint16_t, 32> sides{};
+		std::array<uint16_t, color_count> colors{};
+		int length = 0;
+		int most_numbers = 0;
+		int most_letters = 0;
+		int most_sides = 0;
+		int most_colors = 0;
+
+		void Add(const Card& c) {
+			length++;
+			most_numbers = std::max<int>(most_numbers, ++numbers[c.number & 31]);
+			most_letters = std::max<int>(most_letters, ++letters[c.letter & 31]);
+			most_sides = std::max<int>(most_sides, ++sides[c.sides & 31]);
+			most_colors = std::max<int>(most_colors, ++colors[c.color % color_count]);
+		}
+
+		int Total(uint32_t rules) const {
+			if (length == 0) {
+				return 0;
+			}
+			auto times = [rules](RuleBit rule) { return (rules & Bit(rule)) ? 2 : 1; };
+			return Fib(length) * times(DOUBLE_LENGTH)
+				+ (most_numbers - 1) * times(DOUBLE_NUMBER)
+				+ (most_sides - 1) * times(DOUBLE_SHAPE)
+				+ (most_letters - 1) * times(DOUBLE_LETTER)
+				+ (most_colors - 1) * times(DOUBLE_COLOR);
+		}
+	};
+
+	inline int Score(const Card* run, size_t count, uint32_t rules) {
+		ScoreCounter counter;
+		for (size_t i = 0; i < count; i++) {
+			counter.Add(run[i]);
+		}
+		return counter.Total(rules);
+	}
+
+	// Zobrist keys.  A game's key is the xor of one key per fact about it, so
+	// it can be updated in O(1) as cards move and rules change.  The deck is
+	// deliberately left out: searches treat it as unknown.
+	namespace zobrist {
+		constexpr uint64_t SplitMix(uint64_t x) {
+			x += 0x9E3779B97F4A7C15ull;
+			x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+			x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+			return x ^ (x >> 31);
+		}
+
+		template <size_t N>
+		constexpr std::array<uint64_t, N> MakeKeys(uint64_t stream) {
+			std::array<uint64_t, N> keys{};
+			for (size_t i = 0; i < N; i++) {
+				keys[i] = SplitMix(stream * 0x100000000ull + i);
+			}
+			return keys;
+		}
+
+		constexpr int rule_value_slots = 16;
+
+		inline constexpr auto hand_keys = MakeKeys<max_deck_size>(1);
+		inline constexpr auto run_keys = MakeKeys<max_deck_size>(2);
+		inline constexpr auto last_keys = MakeKeys<max_deck_size>(3);
+		inline constexpr auto rule_keys = MakeKeys<RULE_COUNT * rule_value_slots>(4);
+		inline constexpr uint64_t locked_key = SplitMix(5);
+
+		// Cards are keyed the same way whatever the game length
+		inline int Slot(const Card& c) {
+			return CardId(c, max_game_length);
+		}
+
+		inline uint64_t Hand(const Card& c) { return hand_keys[Slot(c)]; }
+		inline uint64_t Run(const Card& c) { return run_keys[Slot(c)]; }
+		inline uint64_t Last(const Card& c) { return last_keys[Slot(c)]; }
+		inline uint64_t Rule(int rule, int value) { return rule_keys[rule * rule_value_slots + (value & (rule_value_slots - 1))]; }
+	}
+
+	enum Action : int {
+		PLAY_0 = 0, // PLAY_0 + i plays the i'th card in hand
+		END_TURN = hand_limit,
+		DISCARD,
+		UNPLAY,
+		ACTION_COUNT,
+	};
+
+	// One whole game, following the same state flow as the states in Run.h
+	// with the animations skipped
+	struct Game {
+		std::mt19937 rng;
+		int game_length = 5;
+
+		std::array<Card, max_deck_size> deck;
+		int deck_size = 0;
+		HandLanes hand{}; // hand_limit cards at most, the rest is padding for PlayableMask
+		int hand_size = 0;
+		std::array<Card, max_deck_size> in_play;
+		int in_play_size = 0;
+		bool last_locked = false; // the last card in play can not be taken back
+
+		uint32_t rules = 0;
+		std::array<int8_t, RULE_COUNT> rule_values{};
+
+		int score = 0;
+		bool over = false;
+
+		// Rules held on for the whole game or never enabled, for comparing games
+		// with and without one.  Left alone by Reset.  A rule forced on keeps
+		// the duration it started with, it does not count down.
+		uint32_t forced_on = 0;
+		uint32_t forced_off = 0;
+
+		// Zobrist key of the hand, the run, the last card (and whether it is
+		// locked) and the enabled rules with their remaining durations
+		uint64_t key = 0;
+
+		void Reset(uint32_t seed, int length) {
+			rng.seed(seed);
+			game_length = std::clamp(length, 1, max_game_length);
+			deck_size = game_length * game_length * game_length;
+			for (int id = 0; id < deck_size; id++) {
+				deck[id] = MakeCard(id, game_length);
+			}
+			std::shuffle(deck.begin(), deck.begin() + deck_size, rng);
+
+			hand_size = 0;
+			in_play_size = 0;
+			last_locked = false;
+			rules = 0;
+			score = 0;
+			over = false;
+			key = 0;
+			for (int r = 0; r < int(RULE_COUNT); r++) {
+				if (forced_on & (1u << r)) {
+					SetRule(r, rule_info[r].value);
+				}
+			}
+			DrawCards();
+		}
+
+		// The key built from scratch, for checking the incremental one
+		uint64_t ComputeKey() const {
+			uint64_t k = 0;
+			for (int i = 0; i < hand_size; i++) {
+				k ^= zobrist::Hand(hand[i]);
+			}
+			for (int i = 0; i < in_play_size; i++) {
+				k ^= zobrist::Run(in_play[i]);
+			}
+			if (in_play_size > 0) {
+				k ^= zobrist::Last(in_play[in_play_size - 1]);
+			}
+			k ^= last_locked ? zobrist::locked_key : 0;
+			for (int r = 0; r < int(RULE_COUNT); r++) {
+				k ^= (rules & (1u << r)) ? zobrist::Rule(r, rule_values[r]) : 0;
+			}
+			return k;
+		}
+
+		bool RuleEnabled(RuleBit rule) const {
+			return (rules & Bit(rule)) != 0;
+		}
+
+		bool CanPlay(int i) const {
+			return !over && i >= 0 && i < hand_size
+				&& (in_play_size == 0 || IsValid(in_play[in_play_size - 1], hand[i], rules));
+		}
+
+		bool CanEndTurn() const {
+			return !over && in_play_size > 2;
+		}
+
+		bool CanUnplay() const {
+			return !over && in_play_size > 0 && !last_locked;
+		}
+
+		// Bit i set when hand[i] can be played
+		uint32_t PlayableCards() const {
+			if (over) {
+				return 0;
+			}
+			if (in_play_size == 0) {
+				return (1u << hand_size) - 1;
+			}
+			return PlayableMask(in_play[in_play_size - 1], hand, hand_size, rules);
+		}
+
+		// Bit n set when action n would do something
+		uint32_t ActionMask() const {
+			static_assert(PLAY_0 == 0, "play actions line up with hand bits");
+			uint32_t mask = PlayableCards();
+			mask |= CanEndTurn() ? 1u << END_TURN : 0u;
+			mask |= !over ? 1u << DISCARD : 0u;
+			mask |= CanUnplay() ? 1u << UNPLAY : 0u;
+			return mask;
+		}
+
+		// Applies an action and returns the points it scored.  Actions that are
+		// not allowed right now are ignored.
+		int Step(int action) {
+			if (over) {
+				return 0;
+			}
+
+			int score_before = score;
+			if (action >= PLAY_0 && action < PLAY_0 + hand_limit) {
+				if (CanPlay(action - PLAY_0)) {
+					Play(action - PLAY_0);
+				}
+			}
+			else if (action == END_TURN) {
+				if (CanEndTurn()) {
+					EndTurn();
+				}
+			}
+			else if (action == DISCARD) {
+				if (RuleEnabled(DISCARD_TO_DECK)) {
+					InsertIntoDeck(hand.data(), hand_size);
+				}
+				for (int i = 0; i < hand_size; i++) {
+					key ^= zobrist::Hand(hand[i]);
+				}
+				hand_size = 0;
+				EndTurn();
+			}
+			else if (action == UNPLAY) {
+				if (CanUnplay()) {
+					// Whatever was played before it was locked when this card went down
+					const Card c = in_play[--in_play_size];
+					hand[hand_size++] = c;
+					key ^= zobrist::Run(c) ^ zobrist::Last(c) ^ zobrist::Hand(c);
+					if (in_play_size > 0) {
+						key ^= zobrist::Last(in_play[in_play_size - 1]);
+					}
+					SetLastLocked(in_play_size > 0);
+				}
+			}
+			return score - score_before;
+		}
+
+	private:
+		void SetLastLocked(bool locked) {
+			key ^= locked != last_locked ? zobrist::locked_key : 0;
+			last_locked = locked;
+		}
+
+		// Enables, refreshes or (with a negative value) removes a rule, unless
+		// it is forced on or off
+		void SetRule(int r, int value) {
+			if ((value < 0 && (forced_on & (1u << r))) || (value >= 0 && (forced_off & (1u << r)))) {
+				return;
+			}
+			if (rules & (1u << r)) {
+				key ^= zobrist::Rule(r, rule_values[r]);
+			}
+			if (value < 0) {
+				rules &= ~(1u << r);
+				return;
+			}
+			rules |= 1u << r;
+			rule_values[r] = int8_t(value);
+			key ^= zobrist::Rule(r, value);
+		}
+
+		void TickRules(bool on_play) {
+			for (int r = 0; r < int(RULE_COUNT); r++) {
+				bool ticks = on_play ? rule_info[r].tick_on_play : rule_info[r].tick_on_end;
+				if (ticks && (rules & (1u << r)) && !(forced_on & (1u << r))) {
+					SetRule(r, rule_values[r] - 1);
+				}
+			}
+		}
+
+		void Play(int i) {
+			// Playing a card locks the one before it
+			const Card c = hand[i];
+			if (in_play_size > 0) {
+				key ^= zobrist::Last(in_play[in_play_size - 1]);
+			}
+			in_play[in_play_size++] = c;
+			key ^= zobrist::Hand(c) ^ zobrist::Run(c) ^ zobrist::Last(c);
+			SetLastLocked(RuleEnabled(NO_UNPLAY));
+			std::copy(hand.begin() + i + 1, hand.begin() + hand_size, hand.begin() + i);
+			hand_size--;
+			TickRules(true);
+		}
+
+		// Same randomized insertion as Deck::Insert
+		void InsertIntoDeck(const Card* cards, int count) {
+			for (int i = 0; i < count; i++) {
+				deck[deck_size++] = cards[i];
+				size_t slot = std::uniform_int_distribution<size_t>(0, deck_size - 1)(rng);
+				std::swap(deck[slot], deck[deck_size - 1]);
+			}
+		}
+
+		void EndTurn() {
+			//At the end of every round there is a chance to gain or refresh a random rule
+			int enabled = 0;
+			for (uint32_t r = 0; r < RULE_COUNT; r++) {
+				enabled += (rules >> r) & 1;
+			}
+			if (std::uniform_int_distribution<>(0, 5 + enabled)(rng) < 2) {
+				int r = std::uniform_int_distribution<>(0, RULE_COUNT - 1)(rng);
+				SetRule(r, rule_info[r].value);
+			}
+
+			if (in_play_size > 2) {
+				score += Score(in_play.data(), in_play_size, rules);
+			}
+
+			if (RuleEnabled(DISCARD_TO_DECK)) {
+				InsertIntoDeck(in_play.data(), in_play_size);
+			}
+			for (int i = 0; i < in_play_size; i++) {
+				key ^= zobrist::Run(in_play[i]);
+			}
+			if (in_play_size > 0) {
+				key ^= zobrist::Last(in_play[in_play_size - 1]);
+			}
+			in_play_size = 0;
+			SetLastLocked(false);
+
+			TickRules(false);
+			DrawCards();
+		}
+
+		void DrawCards() {
+			while (hand_size < hand_limit && deck_size > 0) {
+				hand[hand_size] = deck[--deck_size];
+				key ^= zobrist::Hand(hand[hand_size++]);
+			}
+			over = hand_size < 3;
+		}
+	};
+}
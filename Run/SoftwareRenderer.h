@@ -0,0 +1,300 @@
+#pragma once
+
+// A CPU implementation of olc::Renderer.
+//
+// Layers and decals are rasterised into an in-memory frame buffer the size of
+// the viewport, so headless tools pay a realistic rendering cost per frame
+// and can inspect the result.  Select it before the implementation of the
+// engine is compiled:
+//
+//	#define OLC_PGE_HEADLESS
+//	#include "olcPixelGameEngine.h"
+//	#include "SoftwareRenderer.h"
+//	#define OLC_GFX_CUSTOM_EX
+//	#define OLC_RENDERER_CUSTOM_EX olc::Renderer_Software
+//	#define OLC_PGE_APPLICATION
+//	#include "olcPixelGameEngine.h"
+
+#include "olcPixelGameEngine.h"
+
+#include <unordered_map>
+
+namespace olc
+{
+	class Renderer_Software : public olc::Renderer
+	{
+	public:
+		struct Texture
+		{
+			uint32_t width = 0;
+			uint32_t height = 0;
+			std::vector<olc::Pixel> pixels;
+		};
+
+		// Pixels a decal is sampled from, row major
+		struct TextureView
+		{
+			uint32_t width = 0;
+			uint32_t height = 0;
+			const olc::Pixel* pixels = nullptr;
+		};
+
+		void PrepareDevice() override {}
+		olc::rcode CreateDevice(std::vector<void*> params, bool bFullScreen, bool bVSYNC) override { return olc::rcode::OK; }
+		olc::rcode DestroyDevice() override { return olc::rcode::OK; }
+		void PrepareDrawing() override {}
+
+		void DisplayFrame() override
+		{
+			nFramesPresented++;
+		}
+
+		void SetDecalMode(const olc::DecalMode& mode) override
+		{
+			nDecalMode = mode;
+		}
+
+		void DrawLayerQuad(const olc::vf2d& offset, const olc::vf2d& scale, const olc::Pixel tint) override
+		{
+			const Texture* tex = Bound();
+			if (tex == nullptr || tex->width == 0 || tex->height == 0) return;
+
+			// Every row samples the same texel columns, so they are found once
+			// and each row is a gather from a single texture row
+			vColumns.resize(size_t(vSize.x));
+			for (int32_t x = 0; x < vSize.x; x++)
+			{
+				float u = (float(x) + 0.5f) / float(vSize.x) * scale.x + offset.x;
+				vColumns[x] = std::clamp(int32_t(u * tex->width), 0, int32_t(tex->width) - 1);
+			}
+
+			const bool bTinted = tint != olc::WHITE;
+			for (int32_t y = 0; y < vSize.y; y++)
+			{
+				float v = (float(y) + 0.5f) / float(vSize.y) * scale.y + offset.y;
+				const olc::Pixel* src = &tex->pixels[std::clamp(int32_t(v * tex->height), 0, int32_t(tex->height) - 1) * tex->width];
+				olc::Pixel* dst = &vFrame[y * vSize.x];
+				for (int32_t x = 0; x < vSize.x; x++)
+				{
+					olc::Pixel p = bTinted ? Modulate(src[vColumns[x]], tint) : src[vColumns[x]];
+					// Opaque and clear texels need no blending
+					if (p.a == 255) { p.a = dst[x].a; dst[x] = p; }
+					else if (p.a != 0) Blend(dst[x], p, olc::DecalMode::NORMAL);
+				}
+			}
+		}
+
+		void DrawDecal(const olc::DecalInstance& decal) override
+		{
+			SetDecalMode(decal.mode);
+
+			TextureView view;
+			if (decal.decal != nullptr)
+			{
+				auto it = mapTextures.find(decal.decal->id);
+				if (it != mapTextures.end()) view = { it->second.width, it->second.height, it->second.pixels.data() };
+			}
+
+			RasteriseDecal(decal, view.pixels != nullptr ? &view : nullptr, vFrame.data(), vSize);
+		}
+
+		uint32_t CreateTexture(const uint32_t width, const uint32_t height, const bool filtered = false, const bool clamp = true) override
+		{
+			uint32_t id = nNextTextureID++;
+			mapTextures[id] = Texture{};
+			return id;
+		}
+
+		void UpdateTexture(uint32_t id, olc::Sprite* spr) override
+		{
+			Texture& tex = mapTextures[id];
+			tex.width = spr->width;
+			tex.height = spr->height;
+			tex.pixels.assign(spr->pColData.begin(), spr->pColData.end());
+		}
+
+		void ReadTexture(uint32_t id, olc::Sprite* spr) override
+		{
+			auto it = mapTextures.find(id);
+			if (it == mapTextures.end()) return;
+			std::copy(it->second.pixels.begin(), it->second.pixels.begin() + std::min(it->second.pixels.size(), spr->pColData.size()), spr->pColData.begin());
+		}
+
+		uint32_t DeleteTexture(const uint32_t id) override
+		{
+			mapTextures.erase(id);
+			if (nBoundTexture == id) nBoundTexture = 0;
+			return id;
+		}
+
+		void ApplyTexture(uint32_t id) override
+		{
+			nBoundTexture = id;
+		}
+
+		void UpdateViewport(const olc::vi2d& pos, const olc::vi2d& size) override
+		{
+			if (size != vSize)
+			{
+				vSize = size;
+				vFrame.assign(size_t(std::max(0, vSize.x * vSize.y)), olc::BLACK);
+			}
+		}
+
+		void ClearBuffer(olc::Pixel p, bool bDepth) override
+		{
+			std::fill(vFrame.begin(), vFrame.end(), p);
+		}
+
+	public:
+		// The last rendered frame, row major at the viewport size
+		const std::vector<olc::Pixel>& GetFrame() const { return vFrame; }
+		const olc::vi2d& GetFrameSize() const { return vSize; }
+		uint64_t FramesPresented() const { return nFramesPresented; }
+
+	private:
+		const Texture* Bound() const
+		{
+			auto it = mapTextures.find(nBoundTexture);
+			return it == mapTextures.end() ? nullptr : &it->second;
+		}
+
+		static olc::Pixel Sample(const TextureView& tex, float u, float v)
+		{
+			if (tex.width == 0 || tex.height == 0) return olc::WHITE;
+			int32_t x = std::clamp(int32_t(u * tex.width), 0, int32_t(tex.width) - 1);
+			int32_t y = std::clamp(int32_t(v * tex.height), 0, int32_t(tex.height) - 1);
+			return tex.pixels[y * tex.width + x];
+		}
+
+		static olc::Pixel Modulate(const olc::Pixel a, const olc::Pixel b)
+		{
+			return olc::Pixel(uint8_t(a.r * b.r / 255), uint8_t(a.g * b.g / 255), uint8_t(a.b * b.b / 255), uint8_t(a.a * b.a / 255));
+		}
+
+		static void Blend(olc::Pixel& dst, const olc::Pixel src, olc::DecalMode mode)
+		{
+			switch (mode)
+			{
+			case olc::DecalMode::ADDITIVE:
+				dst.r = uint8_t(std::min(255, dst.r + src.r * src.a / 255));
+				dst.g = uint8_t(std::min(255, dst.g + src.g * src.a / 255));
+				dst.b = uint8_t(std::min(255, dst.b + src.b * src.a / 255));
+				break;
+			case olc::DecalMode::MULTIPLICATIVE:
+				dst = Modulate(dst, src);
+				break;
+			default:
+				dst.r = uint8_t((src.r * src.a + dst.r * (255 - src.a)) / 255);
+				dst.g = uint8_t((src.g * src.a + dst.g * (255 - src.a)) / 255);
+				dst.b = uint8_t((src.b * src.a + dst.b * (255 - src.a)) / 255);
+				break;
+			}
+		}
+
+	public:
+		// Draws one decal into a row major frame of the given size, the way
+		// DrawDecal does.  tex is null for untextured decals.  Also used to
+		// render decals into sprites, see LayerCache.h.
+		static void RasteriseDecal(const olc::DecalInstance& decal, const TextureView* tex, olc::Pixel* frame, const olc::vi2d& size)
+		{
+			if (decal.mode == olc::DecalMode::WIREFRAME)
+			{
+				// Drawn as a line loop, or a single line for two points
+				for (uint32_t n = 0; n + 1 < decal.points; n++) RasteriseLine(decal, n, n + 1, frame, size);
+				if (decal.points > 2) RasteriseLine(decal, decal.points - 1, 0, frame, size);
+				return;
+			}
+
+			auto triangle = [&](uint32_t a, uint32_t b, uint32_t c) { RasteriseTriangle(decal, tex, a, b, c, frame, size); };
+
+			if (decal.structure == olc::DecalStructure::FAN)
+			{
+				for (uint32_t n = 1; n + 1 < decal.points; n++) triangle(0, n, n + 1);
+			}
+			else if (decal.structure == olc::DecalStructure::STRIP)
+			{
+				for (uint32_t n = 0; n + 2 < decal.points; n++) triangle(n, n + 1, n + 2);
+			}
+			else if (decal.structure == olc::DecalStructure::LIST)
+			{
+				for (uint32_t n = 0; n + 2 < decal.points; n += 3) triangle(n, n + 1, n + 2);
+			}
+		}
+
+	private:
+		// Decal positions are in normalised device coordinates, y up
+		static olc::vf2d ToScreen(const olc::DecalInstance& decal, uint32_t i, const olc::vi2d& size)
+		{
+			return olc::vf2d{ (decal.pos[i].x + 1.0f) * 0.5f * size.x, (1.0f - decal.pos[i].y) * 0.5f * size.y };
+		}
+
+		static void RasteriseTriangle(const olc::DecalInstance& decal, const TextureView* tex, uint32_t a, uint32_t b, uint32_t c, olc::Pixel* frame, const olc::vi2d& size)
+		{
+			olc::vf2d p0 = ToScreen(decal, a, size), p1 = ToScreen(decal, b, size), p2 = ToScreen(decal, c, size);
+			float area = (p1 - p0).cross(p2 - p0);
+			if (std::abs(area) < 1e-6f) return;
+
+			int32_t x0 = std::max(0, int32_t(std::floor(std::min({ p0.x, p1.x, p2.x }))));
+			int32_t x1 = std::min(size.x - 1, int32_t(std::ceil(std::max({ p0.x, p1.x, p2.x }))));
+			int32_t y0 = std::max(0, int32_t(std::floor(std::min({ p0.y, p1.y, p2.y }))));
+			int32_t y1 = std::min(size.y - 1, int32_t(std::ceil(std::max({ p0.y, p1.y, p2.y }))));
+
+			const float inv_area = 1.0f / area;
+			for (int32_t y = y0; y <= y1; y++)
+			{
+				for (int32_t x = x0; x <= x1; x++)
+				{
+					olc::vf2d p = { float(x) + 0.5f, float(y) + 0.5f };
+					float w0 = (p2 - p1).cross(p - p1) * inv_area;
+					float w1 = (p0 - p2).cross(p - p2) * inv_area;
+					float w2 = 1.0f - w0 - w1;
+					if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) continue;
+
+					olc::Pixel texel = olc::WHITE;
+					if (tex != nullptr)
+					{
+						float q = w0 * decal.w[a] + w1 * decal.w[b] + w2 * decal.w[c];
+						olc::vf2d uv = (decal.uv[a] * w0 + decal.uv[b] * w1 + decal.uv[c] * w2) / q;
+						texel = Sample(*tex, uv.x, uv.y);
+					}
+
+					olc::Pixel tint(
+						uint8_t(w0 * decal.tint[a].r + w1 * decal.tint[b].r + w2 * decal.tint[c].r),
+						uint8_t(w0 * decal.tint[a].g + w1 * decal.tint[b].g + w2 * decal.tint[c].g),
+						uint8_t(w0 * decal.tint[a].b + w1 * decal.tint[b].b + w2 * decal.tint[c].b),
+						uint8_t(w0 * decal.tint[a].a + w1 * decal.tint[b].a + w2 * decal.tint[c].a));
+
+					Blend(frame[y * size.x + x], Modulate(texel, tint), decal.mode);
+				}
+			}
+		}
+
+		// One pixel wide in the colour of its first point, stepping along the
+		// major axis
+		static void RasteriseLine(const olc::DecalInstance& decal, uint32_t a, uint32_t b, olc::Pixel* frame, const olc::vi2d& size)
+		{
+			olc::vf2d p0 = ToScreen(decal, a, size), p1 = ToScreen(decal, b, size);
+			olc::vf2d d = p1 - p0;
+			int32_t steps = int32_t(std::ceil(std::max(std::abs(d.x), std::abs(d.y))));
+			for (int32_t i = 0; i <= steps; i++)
+			{
+				float t = steps > 0 ? float(i) / float(steps) : 0.0f;
+				olc::vf2d p = p0 + d * t;
+				int32_t x = int32_t(std::floor(p.x)), y = int32_t(std::floor(p.y));
+				if (x < 0 || y < 0 || x >= size.x || y >= size.y) continue;
+				Blend(frame[y * size.x + x], decal.tint[a], olc::DecalMode::NORMAL);
+			}
+		}
+
+	private:
+		std::unordered_map<uint32_t, Texture> mapTextures;
+		uint32_t nNextTextureID = 1;
+		uint32_t nBoundTexture = 0;
+		olc::DecalMode nDecalMode = olc::DecalMode::NORMAL;
+		olc::vi2d vSize = { 0, 0 };
+		std::vector<olc::Pixel> vFrame;
+		std::vector<int32_t> vColumns;
+		uint64_t nFramesPresented = 0;
+	};
+}
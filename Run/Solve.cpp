@@ -0,0 +1,112 @@
+// Solves seeded games with perfect information, see Solver.h.
+//
+// Build (from the repository root):
+//	g++ -std=c++17 -O2 Run/Solve.cpp -o solve -lpthread
+//	cl /std:c++17 /O2 /EHsc Run\Solve.cpp
+//
+// Usage:
+//	solve <seed> [<last seed>] [--length N] [--beam N] [--threads N] [--off a,b,...]
+//
+// Prints one line per seed: the best score found, the bound no game can
+// beat, turns, states generated and seconds taken.  The bound is only known
+// with discard_to_deck among the rules kept off by --off, and is loose even
+// then, see Solver.h.  The best game is played back before it is reported,
+// so a score that cannot be reproduced fails.
+
+#include "Solver.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace {
+	// Rule keys as in possible_rules, separated by commas
+	bool ParseRules(const std::string& spec, uint32_t& rules) {
+		rules = 0;
+		size_t start = 0;
+		while (start <= spec.size()) {
+			size_t comma = spec.find(',', start);
+			sim::RuleBit rule = sim::RuleIndex(spec.substr(start, comma - start));
+			if (rule == sim::RULE_COUNT) {
+				return false;
+			}
+			rules |= sim::Bit(rule);
+			if (comma == std::string::npos) {
+				break;
+			}
+			start = comma + 1;
+		}
+		return true;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	uint32_t first = 0;
+	uint32_t last = 0;
+	int seeds_given = 0;
+	int length = 5;
+	solver::Options options;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--length" && i + 1 < argc) {
+			length = std::stoi(argv[++i]);
+		}
+		else if (arg == "--beam" && i + 1 < argc) {
+			options.beam_width = std::stoi(argv[++i]);
+		}
+		else if (arg == "--threads" && i + 1 < argc) {
+			options.threads = std::stoi(argv[++i]);
+		}
+		else if (arg == "--off" && i + 1 < argc) {
+			if (!ParseRules(argv[++i], options.rules_off)) {
+				std::printf("Unknown rule in %s\n", argv[i]);
+				return 2;
+			}
+		}
+		else if (arg[0] != '-' && seeds_given < 2) {
+			(seeds_given++ == 0 ? first : last) = uint32_t(std::stoul(arg));
+		}
+		else {
+			std::printf("usage: %s <seed> [<last seed>] [--length N] [--beam N] [--threads N] [--off a,b,...]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (seeds_given == 0) {
+		std::printf("No seed given\n");
+		return 2;
+	}
+	if (seeds_given == 1) {
+		last = first;
+	}
+	if (length < 1 || length > sim::max_game_length) {
+		std::printf("Length must be 1 to %d\n", sim::max_game_length);
+		return 2;
+	}
+
+	std::printf("%-10s %6s %6s %6s %8s %12s %8s\n", "seed", "length", "score", "bound", "turns", "states", "seconds");
+	for (uint32_t seed = first; seed <= last; seed++) {
+		auto start = std::chrono::steady_clock::now();
+		solver::Result result = solver::Solve(seed, length, options);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		sim::Game game;
+		game.forced_off = options.rules_off;
+		game.Reset(seed, length);
+		for (uint8_t action : result.actions) {
+			game.Step(action);
+		}
+		if (!game.over || game.score != result.score) {
+			std::printf("%-10u played back to %d instead of %d\n", seed, game.score, result.score);
+			return 1;
+		}
+
+		std::string bound = result.bound >= 0 ? std::to_string(result.bound) : "-";
+		std::printf("%-10u %6d %6d %6s %8d %12llu %8.2f\n", seed, length, result.score, bound.c_str(), result.turns,
+			(unsigned long long)result.states, seconds);
+		if (seed == last) {
+			break;
+		}
+	}
+	return 0;
+}
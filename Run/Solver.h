@@ -0,0 +1,401 @@
+#pragma once
+
+// Perfect information solver for seeded games.
+//
+// With the seed known the deck order and every rule roll follow from the
+// actions taken, so a game is a deterministic tree of turns.  The solver runs
+// a beam search over it one turn at a time:
+//
+//	- every state in the beam is expanded with every distinct way to finish
+//	  its turn (search::EnumerateTurns), and with each run followed by a
+//	  discard of the rest of the hand
+//	- children are ranked by score plus a value for the cards still to come
+//	  and the best beam_width go on to the next turn
+//	- a child whose score plus FutureBound cannot beat the best finished
+//	  game so far is pruned; the greedy player's score starts that off.
+//	  This needs discard_to_deck kept off, see below.
+//
+// Expansion is split across threads by slices of the beam.  Each thread
+// writes only its own candidates and the previous turn is read only, so no
+// locks are needed.
+//
+// Result::score is a game that was actually played and can be replayed with
+// Result::actions.  It is the number to rate a seed by.
+//
+// FutureBound counts each card left once.  discard_to_deck puts the turn's
+// cards back in the deck, any turn may roll it, and a game that keeps
+// rolling it never ends, so nothing bounds what is left while it can come
+// up.  Bounds only prune, and Result::bound is only set, when
+// Options::rules_off holds discard_to_deck.  Result::bound is then the
+// highest score + FutureBound of any state the beam let go, so no game from
+// the seed can beat it.  The beam lets states go from the first turn, when
+// nearly the whole deck is still to come, so even then it is far above any
+// real game (around 1050 at length 5 for every seed) and says little about
+// how hard a seed is.
+//
+//	solver::Result r = solver::Solve(seed, 5);
+//	std::printf("%d\n", r.score);
+
+#include "Search.h"
+
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace solver {
+	struct Options {
+		int beam_width = 1024;
+		int threads = 0;          // 0 for one per core
+		float card_value = 2.7f;  // points a card not yet played is worth when ranking states
+		uint32_t rules_off = 0;   // rules never enabled, as sim::Game::forced_off
+	};
+
+	struct Result {
+		int score = 0;
+		int bound = -1;           // -1 unless discard_to_deck is off, see above
+		int turns = 0;
+		std::vector<uint8_t> actions;
+		uint64_t states = 0;      // children generated
+	};
+
+	// The most a run of length cards can score.  Of the number, letter and
+	// shape bonuses at most 2 * (length - 1) can be earned together, as any two
+	// different cards differ in one of them and only one card can match in all
+	// three; the color bonus adds length - 1.  Every part may be doubled.
+	inline int RunBound(int length) {
+		if (length < 3) {
+			return 0;
+		}
+		return 2 * sim::Fib(length) + 2 * 3 * (length - 1);
+	}
+
+	// How many of the cards left (deck and hand) have each number, letter,
+	// sides and color, and how those split into groups that fit in a hand
+	struct CardsLeft {
+		std::array<std::array<int, 16>, 4> counts{};
+		// groups[attribute][k], how many runs could hold k cards sharing a value
+		std::array<std::array<int, sim::hand_limit + 1>, 4> groups{};
+		int cards = 0;
+
+		explicit CardsLeft(const sim::Game& game) {
+			for (int i = 0; i < game.deck_size; i++) {
+				Add(game.deck[i], 1);
+			}
+			for (int i = 0; i < game.hand_size; i++) {
+				Add(game.hand[i], 1);
+			}
+		}
+
+		// Adds a card, or with n of -1 takes one away
+		void Add(const sim::Card& c, int n) {
+			Count(0, c.number & 15, n);
+			Count(1, c.letter & 15, n);
+			Count(2, c.sides & 15, n);
+			Count(3, c.color & 15, n);
+			cards += n;
+		}
+
+	private:
+		void Count(int a, int value, int n) {
+			Group(a, counts[a][value], -1);
+			counts[a][value] += n;
+			Group(a, counts[a][value], 1);
+		}
+
+		void Group(int a, int count, int n) {
+			groups[a][sim::hand_limit] += n * (count / sim::hand_limit);
+			groups[a][count % sim::hand_limit] += n;
+		}
+	};
+
+	// The most the cards left can still score.  Every scoring turn takes at
+	// least three of them and at most a full hand, which limits the number of
+	// runs.  A run's bonus for an attribute needs that many of its cards to
+	// share a value, so the bonuses are capped by the biggest groups of one
+	// value among the cards left that fit in a hand, one group per run.  On
+	// top of that the number, letter and shape bonuses are capped together as
+	// in RunBound, and every part may be doubled.
+	inline int FutureBound(const CardsLeft& left) {
+		constexpr int full_hand = sim::hand_limit;
+		const int cards = left.cards;
+		const auto& groups = left.groups;
+		// The most an attribute's bonus adds up to over that many runs, one
+		// group each, biggest first
+		auto bonus = [&groups](int a, int runs) {
+			int total = 0;
+			for (int k = full_hand; k > 1 && runs > 0; k--) {
+				int n = std::min(runs, groups[a][k]);
+				total += n * (k - 1);
+				runs -= n;
+			}
+			return total;
+		};
+		static const std::array<int, full_hand + 1> fib = [] {
+			std::array<int, full_hand + 1> f{};
+			for (int length = 0; length <= full_hand; length++) {
+				f[length] = sim::Fib(length);
+			}
+			return f;
+		}();
+
+		// Until every card is used another run only adds to each part, so
+		// start from the fewest runs that can hold them all
+		int best = 0;
+		for (int runs = std::max(1, std::min((cards + full_hand - 1) / full_hand, cards / 3)); 3 * runs <= cards; runs++) {
+			// Fib grows faster than the length, so the longest runs score most
+			int used = std::min(cards, full_hand * runs);
+			int full = (used - 3 * runs) / (full_hand - 3);
+			int rest = (used - 3 * runs) % (full_hand - 3);
+			int lengths = full * fib[full_hand] + (rest > 0 ? fib[3 + rest] : 0) + (runs - full - (rest > 0)) * fib[3];
+			// From here more runs only make them shorter, and without the group
+			// caps that can only score less
+			if (2 * (lengths + 3 * (used - runs)) <= best) {
+				break;
+			}
+			int shared = std::min(bonus(0, runs) + bonus(1, runs) + bonus(2, runs), 2 * (used - runs));
+			int color = std::min(bonus(3, runs), used - runs);
+			best = std::max(best, 2 * (lengths + shared + color));
+		}
+		return best;
+	}
+
+	inline int FutureBound(const sim::Game& game) {
+		return FutureBound(CardsLeft(game));
+	}
+
+	namespace detail {
+		// Every turn from EnumerateTurns, plus each run that leaves cards in
+		// hand followed by discarding them
+		using AllTurns = std::array<search::Turn, 2 * (1 << sim::hand_limit) + 1>;
+
+		inline int ExpandTurns(const sim::Game& game, AllTurns& all) {
+			search::Turns turns;
+			int count = search::EnumerateTurns(game, turns);
+			std::copy(turns.begin(), turns.begin() + count, all.begin());
+
+			int total = count;
+			uint8_t whole_hand = uint8_t((1u << game.hand_size) - 1);
+			for (int t = 0; t < count; t++) {
+				if (!turns[t].discard && turns[t].mask != whole_hand) {
+					all[total] = turns[t];
+					all[total].discard = true;
+					total++;
+				}
+			}
+			return total;
+		}
+
+		// Where a turn came from, so the best game can be played back
+		struct Node {
+			int parent;
+			search::Turn turn;
+		};
+
+		struct Candidate {
+			int parent;     // index into the current beam
+			int turn;       // index into ExpandTurns of the parent
+			float rank;
+			uint64_t hash;  // states with the same hash are the same game
+			int bound;
+		};
+
+		struct Finished {
+			int score = -1;
+			int parent = -1;
+			int turn = 0;
+		};
+
+		struct Worker {
+			std::vector<Candidate> candidates;
+			Finished best;
+			uint64_t states = 0;
+		};
+
+		// Expands beam[begin, end) into worker, pruning by FutureBound when
+		// prune is set
+		inline void Expand(const std::vector<sim::Game>& beam, size_t begin, size_t end, int incumbent, bool prune, const Options& options, Worker& worker) {
+			AllTurns turns;
+			sim::Game child;
+			for (size_t p = begin; p < end; p++) {
+				int count = ExpandTurns(beam[p], turns);
+				const CardsLeft parent_left(beam[p]);
+				for (int t = 0; t < count; t++) {
+					child = beam[p];
+					search::ApplyTurn(child, turns[t]);
+					worker.states++;
+
+					if (child.over) {
+						if (child.score > worker.best.score) {
+							worker.best = { child.score, int(p), t };
+						}
+						continue;
+					}
+
+					int cards = child.deck_size + child.hand_size;
+					int bound = std::numeric_limits<int>::max();
+					if (prune) {
+						// The turn's cards left the game
+						CardsLeft left = parent_left;
+						for (int i = 0; i < beam[p].hand_size; i++) {
+							if (turns[t].discard || (turns[t].mask >> i & 1)) {
+								left.Add(beam[p].hand[i], -1);
+							}
+						}
+						bound = child.score + FutureBound(left);
+						if (bound <= incumbent) {
+							continue;
+						}
+					}
+					// The rng decides the rest of the game, its next output tells apart
+					// states that only differ in what is still to come
+					uint64_t hash = child.key ^ sim::zobrist::SplitMix(uint64_t(child.deck_size) << 32 | child.rng());
+					worker.candidates.push_back({ int(p), t, float(child.score) + options.card_value * float(cards), hash, bound });
+				}
+			}
+		}
+
+		template <typename F>
+		void ParallelFor(size_t count, int threads, F&& f) {
+			if (threads <= 1 || count < 2) {
+				f(0, size_t(0), count);
+				return;
+			}
+			std::vector<std::thread> pool;
+			size_t per = (count + threads - 1) / threads;
+			for (int w = 0; w < threads; w++) {
+				size_t begin = std::min(count, w * per);
+				size_t end = std::min(count, begin + per);
+				pool.emplace_back([&f, w, begin, end] { f(w, begin, end); });
+			}
+			for (auto& thread : pool) {
+				thread.join();
+			}
+		}
+
+		inline std::vector<uint8_t> Actions(const std::vector<Node>& nodes, int node, const sim::Game& start) {
+			std::vector<const search::Turn*> path;
+			for (; node >= 0; node = nodes[node].parent) {
+				path.push_back(&nodes[node].turn);
+			}
+
+			std::vector<uint8_t> actions;
+			sim::Game game = start;
+			for (auto t = path.rbegin(); t != path.rend(); ++t) {
+				search::ApplyTurn(game, **t, &actions);
+			}
+			return actions;
+		}
+	}
+
+	inline Result Solve(uint32_t seed, int game_length, const Options& options = {}) {
+		int threads = options.threads > 0 ? options.threads : std::max(1, int(std::thread::hardware_concurrency()));
+		size_t width = size_t(std::max(1, options.beam_width));
+
+		Result result;
+		std::vector<sim::Game> beam(1);
+		beam[0].forced_off = options.rules_off;
+		beam[0].Reset(seed, game_length);
+		const bool prune = (options.rules_off & sim::Bit(sim::DISCARD_TO_DECK)) != 0;
+
+		// The greedy player's game is the first one to beat
+		{
+			TranspositionTable table(4 << 20);
+			sim::Game game = beam[0];
+			while (!game.over) {
+				int action = search::GreedyAction(game, table);
+				result.actions.push_back(uint8_t(action));
+				game.Step(action);
+			}
+			result.score = game.score;
+		}
+
+		std::vector<detail::Node> nodes;
+		std::vector<int> beam_nodes(1, -1);
+		int best_node = -2; // -2 while the greedy game is still the best
+		int dropped_bound = 0;
+
+		std::vector<detail::Worker> workers(threads);
+		std::vector<detail::Candidate> candidates;
+		std::vector<sim::Game> next_beam;
+		std::vector<int> next_nodes;
+
+		for (int turn = 0; !beam.empty(); turn++) {
+			for (auto& w : workers) {
+				w.candidates.clear();
+				w.best = {};
+			}
+			detail::ParallelFor(beam.size(), threads, [&](int w, size_t begin, size_t end) {
+				detail::Expand(beam, begin, end, result.score, prune, options, workers[w]);
+			});
+
+			candidates.clear();
+			for (auto& w : workers) {
+				result.states += w.states;
+				w.states = 0;
+				candidates.insert(candidates.end(), w.candidates.begin(), w.candidates.end());
+				if (w.best.score > result.score) {
+					detail::AllTurns turns;
+					detail::ExpandTurns(beam[w.best.parent], turns);
+					nodes.push_back({ beam_nodes[w.best.parent], turns[w.best.turn] });
+					best_node = int(nodes.size()) - 1;
+					result.score = w.best.score;
+					result.turns = turn + 1;
+				}
+			}
+
+			// Keep the best ranked copy of each state, then the best width of those
+			std::sort(candidates.begin(), candidates.end(), [](const detail::Candidate& a, const detail::Candidate& b) {
+				return a.hash != b.hash ? a.hash < b.hash : a.rank > b.rank;
+			});
+			candidates.erase(std::unique(candidates.begin(), candidates.end(), [](const detail::Candidate& a, const detail::Candidate& b) {
+				return a.hash == b.hash;
+			}), candidates.end());
+			candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](const detail::Candidate& c) {
+				return c.bound <= result.score;
+			}), candidates.end());
+
+			if (candidates.size() > width) {
+				std::nth_element(candidates.begin(), candidates.begin() + width, candidates.end(), [](const detail::Candidate& a, const detail::Candidate& b) {
+					return a.rank > b.rank;
+				});
+				for (size_t i = width; i < candidates.size(); i++) {
+					dropped_bound = std::max(dropped_bound, candidates[i].bound);
+				}
+				candidates.resize(width);
+			}
+
+			next_beam.resize(candidates.size());
+			next_nodes.resize(candidates.size());
+			size_t first_node = nodes.size();
+			nodes.resize(first_node + candidates.size());
+			detail::ParallelFor(candidates.size(), threads, [&](int, size_t begin, size_t end) {
+				detail::AllTurns turns;
+				for (size_t i = begin; i < end; i++) {
+					const detail::Candidate& c = candidates[i];
+					detail::ExpandTurns(beam[c.parent], turns);
+					next_beam[i] = beam[c.parent];
+					search::ApplyTurn(next_beam[i], turns[c.turn]);
+					nodes[first_node + i] = { beam_nodes[c.parent], turns[c.turn] };
+					next_nodes[i] = int(first_node + i);
+				}
+			});
+			std::swap(beam, next_beam);
+			std::swap(beam_nodes, next_nodes);
+		}
+
+		if (best_node >= 0) {
+			sim::Game start;
+			start.forced_off = options.rules_off;
+			start.Reset(seed, game_length);
+			result.actions = detail::Actions(nodes, best_node, start);
+		}
+		else {
+			result.turns = 0;
+			for (uint8_t action : result.actions) {
+				result.turns += action == sim::END_TURN || action == sim::DISCARD;
+			}
+		}
+		result.bound = prune ? std::max(result.score, dropped_bound) : -1;
+		return result;
+	}
+}
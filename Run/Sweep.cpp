@@ -0,0 +1,462 @@
+// Plays a range of seeds at several game lengths with a reference bot and
+// picks out the seeds that fall in target difficulty bands, for curating
+// daily challenges.
+//
+// Build (from the repository root):
+//	g++ -std=c++17 -O2 Run/Sweep.cpp -o sweep -lpthread
+//	cl /std:c++17 /O2 /EHsc Run\Sweep.cpp
+//
+// Usage:
+//	sweep [--first N] [--count N] [--lengths 5,6,7,9] [--bot greedy|rollout:N|planner:NODES]
+//	      [--threads N] [--out file] [--band LENGTH:MIN-MAX]... [--max-dead F]
+//	sweep --read file [--band LENGTH:MIN-MAX]... [--max-dead F]
+//
+// For every seed and length it records the final score, the number of turns,
+// the rules seen (a bitmask of sim::RuleBit) and how many turns started with
+// no run of three in hand.  Seeds inside every --band (score at that length)
+// and at or under --max-dead (dead hands per turn, at every length) are
+// printed one per line after a summary starting with #.
+//
+// Seeds are handed out in blocks of a fixed size.  Each worker plays whole
+// blocks with its own table and game and writes only its own block; the
+// blocks are then written in seed order.  The bot's own random numbers come
+// from the seed and length, so neither the results nor the file depend on the
+// number of threads.  The planner is given a node budget rather than a time
+// one for the same reason, and starts every game with an empty table, as
+// it reuses values it has stored.
+//
+// File format (native byte order):
+//	"RUNSWEEP" uint32 version, uint32 first seed, uint64 seed count,
+//	uint32 block size, uint32 length count, uint32 lengths[length count]
+//	then per block of up to block size seeds, per length, the columns
+//	uint16 score[n], uint16 turns[n], uint16 rules_seen[n], uint16 dead_hands[n]
+
+#include "Planner.h"
+#include "Search.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+	constexpr char magic[8] = { 'R', 'U', 'N', 'S', 'W', 'E', 'E', 'P' };
+	constexpr uint32_t version = 1;
+	constexpr int column_count = 4;
+
+	enum Column { SCORE, TURNS, RULES_SEEN, DEAD_HANDS };
+
+	enum class BotKind { GREEDY, ROLLOUT, PLANNER };
+
+	struct Bot {
+		BotKind kind = BotKind::GREEDY;
+		int rollouts = 16;
+		uint64_t nodes = 100; // planner nodes searched per action, about 5ms
+	};
+
+	struct Header {
+		uint32_t first = 0;
+		uint64_t count = 0;
+		uint32_t block_size = 1 << 10;
+		std::vector<uint32_t> lengths;
+	};
+
+	// columns[length index][column][seed in block]
+	struct Block {
+		std::vector<std::vector<std::vector<uint16_t>>> columns;
+
+		void Resize(size_t lengths, size_t seeds) {
+			columns.resize(lengths);
+			for (auto& length : columns) {
+				length.resize(column_count);
+				for (auto& column : length) {
+					column.resize(seeds);
+				}
+			}
+		}
+
+		size_t Seeds() const {
+			return columns.empty() ? 0 : columns[0][0].size();
+		}
+	};
+
+	struct Worker {
+		TranspositionTable table{ 16 << 20 };
+		sim::Game game;
+	};
+
+	uint16_t Clamp16(int value) {
+		return uint16_t(std::clamp(value, 0, 0xFFFF));
+	}
+
+	int BotAction(const Bot& bot, const sim::Game& game, uint32_t stream, TranspositionTable& table) {
+		switch (bot.kind) {
+		case BotKind::ROLLOUT: return search::RolloutAction(game, bot.rollouts, stream, table);
+		case BotKind::PLANNER: {
+			planner::Options options;
+			options.budget_ms = 1e9;
+			options.max_nodes = bot.nodes;
+			return planner::Choose(game, options, table, stream).action;
+		}
+		default: return search::GreedyAction(game, table);
+		}
+	}
+
+	void PlayGame(uint32_t seed, int length, const Bot& bot, Worker& worker, Block& block, size_t length_index, size_t slot) {
+		sim::Game& game = worker.game;
+		game.Reset(seed, length);
+		if (bot.kind == BotKind::PLANNER) {
+			worker.table.Clear();
+		}
+		uint32_t stream = uint32_t(sim::zobrist::SplitMix(uint64_t(seed) << 8 | uint64_t(length)));
+
+		int turns = 0;
+		int dead = 0;
+		uint32_t rules_seen = 0;
+		while (!game.over) {
+			if (game.in_play_size == 0 && search::BestRun(game, worker.table).score < 0) {
+				dead++;
+			}
+			int action = BotAction(bot, game, stream++, worker.table);
+			game.Step(action);
+			rules_seen |= game.rules;
+			turns += (action == sim::END_TURN || action == sim::DISCARD) && game.in_play_size == 0;
+		}
+
+		auto& columns = block.columns[length_index];
+		columns[SCORE][slot] = Clamp16(game.score);
+		columns[TURNS][slot] = Clamp16(turns);
+		columns[RULES_SEEN][slot] = uint16_t(rules_seen);
+		columns[DEAD_HANDS][slot] = Clamp16(dead);
+	}
+
+	void PlayBlock(const Header& header, uint64_t block_index, const Bot& bot, Worker& worker, Block& block) {
+		uint64_t begin = block_index * header.block_size;
+		size_t seeds = size_t(std::min<uint64_t>(header.block_size, header.count - begin));
+		block.Resize(header.lengths.size(), seeds);
+		for (size_t i = 0; i < seeds; i++) {
+			uint32_t seed = uint32_t(header.first + begin + i);
+			for (size_t l = 0; l < header.lengths.size(); l++) {
+				PlayGame(seed, int(header.lengths[l]), bot, worker, block, l, i);
+			}
+		}
+	}
+
+	template <typename T>
+	void Write(std::ostream& out, const T& value) {
+		out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template <typename T>
+	bool Read(std::istream& in, T& value) {
+		return bool(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+	}
+
+	void WriteHeader(std::ostream& out, const Header& header) {
+		out.write(magic, sizeof(magic));
+		Write(out, version);
+		Write(out, header.first);
+		Write(out, header.count);
+		Write(out, header.block_size);
+		Write(out, uint32_t(header.lengths.size()));
+		for (uint32_t length : header.lengths) {
+			Write(out, length);
+		}
+	}
+
+	bool ReadHeader(std::istream& in, Header& header) {
+		char file_magic[sizeof(magic)];
+		uint32_t file_version = 0;
+		uint32_t length_count = 0;
+		if (!in.read(file_magic, sizeof(file_magic)) || std::memcmp(file_magic, magic, sizeof(magic)) != 0
+			|| !Read(in, file_version) || file_version != version
+			|| !Read(in, header.first) || !Read(in, header.count) || !Read(in, header.block_size)
+			|| !Read(in, length_count) || length_count > 64 || header.block_size == 0) {
+			return false;
+		}
+		header.lengths.resize(length_count);
+		for (auto& length : header.lengths) {
+			if (!Read(in, length)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool WriteBlock(std::ostream& out, const Block& block) {
+		for (const auto& length : block.columns) {
+			for (const auto& column : length) {
+				if (!out.write(reinterpret_cast<const char*>(column.data()), std::streamsize(column.size() * sizeof(uint16_t)))) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	bool ReadBlock(std::istream& in, size_t lengths, size_t seeds, Block& block) {
+		block.Resize(lengths, seeds);
+		for (auto& length : block.columns) {
+			for (auto& column : length) {
+				if (!in.read(reinterpret_cast<char*>(column.data()), std::streamsize(column.size() * sizeof(uint16_t)))) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	struct Band {
+		uint32_t length;
+		int min;
+		int max;
+	};
+
+	// Selects seeds and keeps the per length totals for the summary
+	struct Selector {
+		explicit Selector(const Header& header_) : header(header_) {}
+
+		const Header& header;
+		std::vector<Band> bands;
+		double max_dead = 1.0;
+
+		struct Totals {
+			double score = 0.0;
+			double turns = 0.0;
+			double dead = 0.0;
+			uint32_t rules_seen = 0;
+		};
+		std::vector<Totals> totals;
+		std::vector<uint32_t> selected;
+
+		void Add(const Block& block, uint64_t first_in_block) {
+			totals.resize(header.lengths.size());
+			for (size_t i = 0; i < block.Seeds(); i++) {
+				bool keep = true;
+				for (size_t l = 0; l < header.lengths.size(); l++) {
+					const auto& columns = block.columns[l];
+					int score = columns[SCORE][i];
+					int turns = columns[TURNS][i];
+					int dead = columns[DEAD_HANDS][i];
+
+					totals[l].score += score;
+					totals[l].turns += turns;
+					totals[l].dead += dead;
+					totals[l].rules_seen |= columns[RULES_SEEN][i];
+
+					keep = keep && double(dead) <= max_dead * double(std::max(turns, 1));
+					for (const Band& band : bands) {
+						keep = keep && (band.length != header.lengths[l] || (score >= band.min && score <= band.max));
+					}
+				}
+				if (keep) {
+					selected.push_back(uint32_t(header.first + first_in_block + i));
+				}
+			}
+		}
+
+		void Print() const {
+			double n = double(std::max<uint64_t>(header.count, 1));
+			std::printf("# %llu seeds from %u\n", (unsigned long long)header.count, header.first);
+			std::printf("# %6s %10s %10s %10s %10s\n", "length", "score", "turns", "dead/turn", "rules seen");
+			for (size_t l = 0; l < totals.size(); l++) {
+				const Totals& t = totals[l];
+				std::printf("# %6u %10.1f %10.1f %10.3f %10x\n", header.lengths[l], t.score / n, t.turns / n,
+					t.dead / std::max(t.turns, 1.0), t.rules_seen);
+			}
+			std::printf("# %zu selected\n", selected.size());
+			for (uint32_t seed : selected) {
+				std::printf("%u\n", seed);
+			}
+		}
+	};
+
+	bool ParseBot(const std::string& spec, Bot& bot) {
+		size_t colon = spec.find(':');
+		std::string name = spec.substr(0, colon);
+		std::string value = colon == std::string::npos ? "" : spec.substr(colon + 1);
+		if (name == "greedy") {
+			bot.kind = BotKind::GREEDY;
+		}
+		else if (name == "rollout") {
+			bot.kind = BotKind::ROLLOUT;
+			bot.rollouts = value.empty() ? bot.rollouts : std::stoi(value);
+		}
+		else if (name == "planner") {
+			bot.kind = BotKind::PLANNER;
+			bot.nodes = value.empty() ? bot.nodes : std::stoull(value);
+		}
+		else {
+			return false;
+		}
+		return true;
+	}
+
+	bool ParseLengths(const std::string& spec, std::vector<uint32_t>& lengths) {
+		lengths.clear();
+		size_t start = 0;
+		while (start <= spec.size()) {
+			size_t comma = spec.find(',', start);
+			int length = std::stoi(spec.substr(start, comma - start));
+			if (length < 1 || length > sim::max_game_length) {
+				return false;
+			}
+			lengths.push_back(uint32_t(length));
+			if (comma == std::string::npos) {
+				break;
+			}
+			start = comma + 1;
+		}
+		return !lengths.empty();
+	}
+
+	bool ParseBand(const std::string& spec, Band& band) {
+		size_t colon = spec.find(':');
+		size_t dash = spec.find('-', colon);
+		if (colon == std::string::npos || dash == std::string::npos) {
+			return false;
+		}
+		band.length = uint32_t(std::stoi(spec.substr(0, colon)));
+		band.min = std::stoi(spec.substr(colon + 1, dash - colon - 1));
+		band.max = std::stoi(spec.substr(dash + 1));
+		return true;
+	}
+
+	int Usage(const char* name) {
+		std::printf("usage: %s [--first N] [--count N] [--lengths 5,6,7,9] [--bot greedy|rollout:N|planner:NODES]\n"
+			"          [--threads N] [--out file] [--band LENGTH:MIN-MAX]... [--max-dead F]\n"
+			"       %s --read file [--band LENGTH:MIN-MAX]... [--max-dead F]\n", name, name);
+		return 2;
+	}
+
+	int ReadSweep(const std::string& path, Selector& selector, Header& header) {
+		std::ifstream in(path, std::ios::binary);
+		if (!in || !ReadHeader(in, header)) {
+			std::printf("Could not read %s\n", path.c_str());
+			return 2;
+		}
+
+		Block block;
+		for (uint64_t begin = 0; begin < header.count; begin += header.block_size) {
+			size_t seeds = size_t(std::min<uint64_t>(header.block_size, header.count - begin));
+			if (!ReadBlock(in, header.lengths.size(), seeds, block)) {
+				std::printf("%s ends after %llu seeds\n", path.c_str(), (unsigned long long)begin);
+				return 2;
+			}
+			selector.Add(block, begin);
+		}
+		selector.Print();
+		return 0;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	Header header;
+	header.count = 1000;
+	header.lengths = { 5, 6, 7, 9 };
+	Bot bot;
+	int threads = std::max(1, int(std::thread::hardware_concurrency()));
+	std::string out_path;
+	std::string read_path;
+	Selector selector(header);
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool has_value = i + 1 < argc;
+		if (arg == "--first" && has_value) {
+			header.first = uint32_t(std::stoul(argv[++i]));
+		}
+		else if (arg == "--count" && has_value) {
+			header.count = std::stoull(argv[++i]);
+		}
+		else if (arg == "--lengths" && has_value) {
+			if (!ParseLengths(argv[++i], header.lengths)) {
+				std::printf("Lengths must be 1 to %d\n", sim::max_game_length);
+				return 2;
+			}
+		}
+		else if (arg == "--bot" && has_value) {
+			if (!ParseBot(argv[++i], bot)) {
+				std::printf("Unknown bot %s\n", argv[i]);
+				return 2;
+			}
+		}
+		else if (arg == "--threads" && has_value) {
+			threads = std::max(1, std::stoi(argv[++i]));
+		}
+		else if (arg == "--out" && has_value) {
+			out_path = argv[++i];
+		}
+		else if (arg == "--read" && has_value) {
+			read_path = argv[++i];
+		}
+		else if (arg == "--band" && has_value) {
+			Band band;
+			if (!ParseBand(argv[++i], band)) {
+				std::printf("Bands look like LENGTH:MIN-MAX\n");
+				return 2;
+			}
+			selector.bands.push_back(band);
+		}
+		else if (arg == "--max-dead" && has_value) {
+			selector.max_dead = std::stod(argv[++i]);
+		}
+		else {
+			return Usage(argv[0]);
+		}
+	}
+
+	if (!read_path.empty()) {
+		return ReadSweep(read_path, selector, header);
+	}
+
+	std::ofstream out;
+	if (!out_path.empty()) {
+		out.open(out_path, std::ios::binary);
+		if (!out.is_open()) {
+			std::printf("Could not write %s\n", out_path.c_str());
+			return 2;
+		}
+		WriteHeader(out, header);
+	}
+
+	std::vector<Worker> workers(threads);
+	std::vector<Block> blocks(threads);
+	uint64_t block_count = (header.count + header.block_size - 1) / header.block_size;
+	auto start = std::chrono::steady_clock::now();
+
+	// One block per worker per round, written in order once the round is done
+	for (uint64_t round = 0; round < block_count; round += threads) {
+		int active = int(std::min<uint64_t>(threads, block_count - round));
+		std::vector<std::thread> pool;
+		for (int w = 0; w < active; w++) {
+			pool.emplace_back([&, w] { PlayBlock(header, round + w, bot, workers[w], blocks[w]); });
+		}
+		for (auto& thread : pool) {
+			thread.join();
+		}
+
+		for (int w = 0; w < active; w++) {
+			uint64_t first_in_block = (round + w) * header.block_size;
+			if (out.is_open() && !WriteBlock(out, blocks[w])) {
+				std::printf("Could not write %s\n", out_path.c_str());
+				return 2;
+			}
+			selector.Add(blocks[w], first_in_block);
+		}
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		uint64_t done = std::min<uint64_t>(header.count, (round + active) * header.block_size);
+		std::fprintf(stderr, "%llu / %llu seeds, %.0f seeds/s\n", (unsigned long long)done, (unsigned long long)header.count, done / std::max(seconds, 1e-9));
+	}
+
+	if (out.is_open() && !out.flush()) {
+		std::printf("Could not write %s\n", out_path.c_str());
+		return 2;
+	}
+	selector.Print();
+	return 0;
+}
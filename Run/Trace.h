@@ -0,0 +1,201 @@
+#pragma once
+
+// Scoped trace markers that can be dumped to Chrome / Perfetto trace JSON
+// (load the file in chrome://tracing or ui.perfetto.dev).
+//
+// Tracing is compiled out entirely unless RUN_TRACE is defined.  When it is
+// enabled every thread that records an event gets its own fixed size ring
+// buffer, so recording never takes a lock; only the first event on a new
+// thread registers the buffer.  Once a buffer is full the oldest events are
+// overwritten.
+//
+// This header must be included before olcPixelGameEngine.h so the engine's
+// OLC_TRACE_SCOPE / OLC_TRACE_FRAME hooks pick up the markers.
+//
+//	RUN_TRACE_SCOPE("Score");          // duration of the enclosing scope
+//	RUN_TRACE_INSTANT("Shuffle");      // a single point in time
+//	RUN_TRACE_FRAME();                 // start of a new frame
+//	RUN_TRACE_DUMP("run_trace.json");  // write everything recorded so far
+//
+// Event names must be string literals (or otherwise outlive the trace).
+
+#if defined(RUN_TRACE)
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace trace {
+	struct Event {
+		const char* name;
+		uint64_t start_ns;
+		uint64_t duration_ns;
+		uint32_t frame;
+		bool instant;
+	};
+
+	// Single producer ring.  Only the owning thread writes; Dump() reads the
+	// events published through head while the writer may keep going, so every
+	// field is atomic and the writer announces each slot in writing before it
+	// touches it.  A reader that checks writing after its copy knows which
+	// slots may have changed underneath it.
+	struct ThreadBuffer {
+		static constexpr size_t capacity = 1 << 16;
+
+		struct Slot {
+			std::atomic<const char*> name{ nullptr };
+			std::atomic<uint64_t> start_ns{ 0 };
+			std::atomic<uint64_t> duration_ns{ 0 };
+			std::atomic<uint32_t> frame{ 0 };
+			std::atomic<bool> instant{ false };
+		};
+
+		std::array<Slot, capacity> slots;
+		std::atomic<uint64_t> head{ 0 };    // events published
+		std::atomic<uint64_t> writing{ 0 }; // events started, head or head + 1
+		uint32_t thread_id = 0;
+
+		void Push(const Event& e) {
+			uint64_t h = head.load(std::memory_order_relaxed);
+			writing.store(h + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			Slot& slot = slots[h & (capacity - 1)];
+			slot.name.store(e.name, std::memory_order_relaxed);
+			slot.start_ns.store(e.start_ns, std::memory_order_relaxed);
+			slot.duration_ns.store(e.duration_ns, std::memory_order_relaxed);
+			slot.frame.store(e.frame, std::memory_order_relaxed);
+			slot.instant.store(e.instant, std::memory_order_relaxed);
+			head.store(h + 1, std::memory_order_release);
+		}
+
+		Event Load(uint64_t i) const {
+			const Slot& slot = slots[i & (capacity - 1)];
+			return { slot.name.load(std::memory_order_relaxed), slot.start_ns.load(std::memory_order_relaxed),
+				slot.duration_ns.load(std::memory_order_relaxed), slot.frame.load(std::memory_order_relaxed),
+				slot.instant.load(std::memory_order_relaxed) };
+		}
+	};
+
+	struct Registry {
+		std::mutex mutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+	};
+
+	inline Registry& GetRegistry() {
+		static Registry registry;
+		return registry;
+	}
+
+	inline std::atomic<uint32_t> current_frame{ 0 };
+
+	inline uint64_t Now() {
+		static const auto epoch = std::chrono::steady_clock::now();
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+	}
+
+	inline ThreadBuffer& LocalBuffer() {
+		thread_local ThreadBuffer* buffer = [] {
+			auto& registry = GetRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			registry.buffers.push_back(std::make_unique<ThreadBuffer>());
+			registry.buffers.back()->thread_id = static_cast<uint32_t>(registry.buffers.size());
+			return registry.buffers.back().get();
+		}();
+		return *buffer;
+	}
+
+	inline void NextFrame() {
+		current_frame.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	inline void Instant(const char* name) {
+		LocalBuffer().Push({ name, Now(), 0, current_frame.load(std::memory_order_relaxed), true });
+	}
+
+	struct Scope {
+		const char* name;
+		uint64_t start;
+		uint32_t frame;
+
+		explicit Scope(const char* name_) : name(name_), start(Now()), frame(current_frame.load(std::memory_order_relaxed)) {}
+		~Scope() {
+			LocalBuffer().Push({ name, start, Now() - start, frame, false });
+		}
+	};
+
+	// Writes every event still held in the ring buffers as Chrome trace JSON.
+	// Safe to call while other threads keep recording; events that were
+	// overwritten during the copy are dropped rather than reported torn.
+	inline bool Dump(const std::string& path) {
+		std::ofstream out(path);
+		if (!out) {
+			return false;
+		}
+
+		out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		bool first = true;
+
+		auto& registry = GetRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		for (const auto& buffer : registry.buffers) {
+			uint64_t end = buffer->head.load(std::memory_order_acquire);
+			uint64_t begin = end > ThreadBuffer::capacity ? end - ThreadBuffer::capacity : 0;
+
+			std::vector<Event> events;
+			events.reserve(end - begin);
+			for (uint64_t i = begin; i < end; i++) {
+				events.push_back(buffer->Load(i));
+			}
+
+			// Anything the writer lapped while we were copying, including the
+			// slot it may be halfway through, is unreliable
+			std::atomic_thread_fence(std::memory_order_acquire);
+			uint64_t after = buffer->writing.load(std::memory_order_relaxed);
+			uint64_t skip = after > begin + ThreadBuffer::capacity ? after - begin - ThreadBuffer::capacity : 0;
+
+			for (uint64_t i = skip; i < events.size(); i++) {
+				const Event& e = events[i];
+				out << (first ? "" : ",\n");
+				first = false;
+				out << "{\"name\":\"" << e.name << "\",\"cat\":\"run\",\"ph\":\"" << (e.instant ? "i" : "X") << "\""
+					<< ",\"pid\":1,\"tid\":" << buffer->thread_id
+					<< ",\"ts\":" << e.start_ns / 1000 << "." << (e.start_ns % 1000) / 100;
+				if (e.instant) {
+					out << ",\"s\":\"t\"";
+				}
+				else {
+					out << ",\"dur\":" << e.duration_ns / 1000 << "." << (e.duration_ns % 1000) / 100;
+				}
+				out << ",\"args\":{\"frame\":" << e.frame << "}}";
+			}
+		}
+
+		out << "\n]}\n";
+		return true;
+	}
+}
+
+#define RUN_TRACE_CONCAT_(a, b) a##b
+#define RUN_TRACE_CONCAT(a, b) RUN_TRACE_CONCAT_(a, b)
+#define RUN_TRACE_SCOPE(name) trace::Scope RUN_TRACE_CONCAT(run_trace_scope_, __LINE__){ name }
+#define RUN_TRACE_INSTANT(name) trace::Instant(name)
+#define RUN_TRACE_FRAME() trace::NextFrame()
+#define RUN_TRACE_DUMP(path) trace::Dump(path)
+
+#define OLC_TRACE_SCOPE(name) RUN_TRACE_SCOPE(name)
+#define OLC_TRACE_FRAME() RUN_TRACE_FRAME()
+
+#else
+
+#define RUN_TRACE_SCOPE(name) ((void)0)
+#define RUN_TRACE_INSTANT(name) ((void)0)
+#define RUN_TRACE_FRAME() ((void)0)
+#define RUN_TRACE_DUMP(path) ((void)0)
+
+#endif
@@ -0,0 +1,197 @@
+#pragma once
+
+// A fixed size transposition table shared between search threads.
+//
+// Entries are stored lock free with the xor trick: each slot holds the
+// packed entry and the key xor'd with it, both written with relaxed atomics.
+// A slot torn by two threads writing at once simply fails to match its key
+// on the next probe, so readers never see a mixed up entry and nothing ever
+// waits.
+//
+// Slots are grouped four to a 64 byte bucket.  Storing into a full bucket
+// evicts according to the replacement policy.  Memory is allocated once, up
+// to the budget given to the constructor.
+//
+//	TranspositionTable table(64 << 20);
+//	TranspositionTable::Entry e;
+//	if (table.Probe(game.key, e) && e.depth >= depth) return e.value;
+//	...
+//	table.Store(game.key, { value, depth, TranspositionTable::EXACT });
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+
+class TranspositionTable {
+public:
+	enum Bound : uint8_t {
+		EXACT,
+		LOWER, // the value is at least this
+		UPPER, // the value is at most this
+	};
+
+	enum class Replacement {
+		ALWAYS,        // newest entry wins
+		DEPTH,         // keep the entry searched deepest
+		DEPTH_AND_AGE, // keep the deepest, but let entries from old searches go first
+	};
+
+	struct Entry {
+		float value = 0.0f;
+		uint8_t depth = 0; // how much work the value represents, bigger is better
+		Bound bound = EXACT;
+		uint8_t move = 0;  // best action found, if the caller wants one
+	};
+
+	explicit TranspositionTable(size_t budget_bytes, Replacement replacement_ = Replacement::DEPTH_AND_AGE)
+		: replacement(replacement_) {
+		bucket_count = 1;
+		while (bucket_count * 2 * sizeof(Bucket) <= budget_bytes) {
+			bucket_count *= 2;
+		}
+		buckets.reset(new Bucket[bucket_count]);
+		Clear();
+	}
+
+	// Not safe while other threads are using the table
+	void Clear() {
+		for (size_t b = 0; b < bucket_count; b++) {
+			for (auto& slot : buckets[b].slots) {
+				slot.check.store(0, std::memory_order_relaxed);
+				slot.data.store(0, std::memory_order_relaxed);
+			}
+		}
+		generation.store(1, std::memory_order_relaxed);
+	}
+
+	// Call at the start of each search so entries from earlier ones age out
+	void NewSearch() {
+		generation.store(uint8_t(generation.load(std::memory_order_relaxed) + 1) | 1, std::memory_order_relaxed);
+	}
+
+	bool Probe(uint64_t key, Entry& entry) const {
+		const Bucket& bucket = buckets[key & (bucket_count - 1)];
+		for (const auto& slot : bucket.slots) {
+			uint64_t data = slot.data.load(std::memory_order_relaxed);
+			if ((slot.check.load(std::memory_order_relaxed) ^ data) == key && data != 0) {
+				entry = Unpack(data);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void Store(uint64_t key, const Entry& entry) {
+		Bucket& bucket = buckets[key & (bucket_count - 1)];
+		uint8_t now = generation.load(std::memory_order_relaxed);
+
+		// Ties go to the first slot scanned, so the scan starts at a slot picked
+		// by key bits the bucket index does not use.  Otherwise equally worthy
+		// entries, every one under ALWAYS, would all evict the same slot.
+		int first = int((key >> 56) % slots_per_bucket);
+		Slot* victim = nullptr;
+		int victim_worth = 0;
+		int victim_age = 0;
+		for (int n = 0; n < slots_per_bucket; n++) {
+			Slot& slot = bucket.slots[(first + n) % slots_per_bucket];
+			uint64_t data = slot.data.load(std::memory_order_relaxed);
+			if (data == 0) {
+				if (victim == nullptr || victim_worth != empty_worth) {
+					victim = &slot;
+					victim_worth = empty_worth;
+				}
+				continue;
+			}
+			Entry old = Unpack(data);
+			if ((slot.check.load(std::memory_order_relaxed) ^ data) == key) {
+				// Same position, only overwrite a deeper result from this search if asked to
+				if (replacement != Replacement::ALWAYS && old.depth > entry.depth && Age(data, now) == 0) {
+					return;
+				}
+				victim = &slot;
+				break;
+			}
+
+			// The older of two equally worthy entries goes first
+			int age = Age(data, now);
+			int worth = Worth(old.depth, age);
+			if (victim == nullptr || worth < victim_worth || (worth == victim_worth && age > victim_age)) {
+				victim = &slot;
+				victim_worth = worth;
+				victim_age = age;
+			}
+		}
+
+		uint64_t data = Pack(entry, now);
+		victim->data.store(data, std::memory_order_relaxed);
+		victim->check.store(key ^ data, std::memory_order_relaxed);
+	}
+
+	// Fraction of a sample of slots used by the current search, 0 to 1
+	double Usage() const {
+		size_t sample = std::min<size_t>(bucket_count, 1024);
+		uint8_t now = generation.load(std::memory_order_relaxed);
+		size_t used = 0;
+		for (size_t b = 0; b < sample; b++) {
+			for (const auto& slot : buckets[b].slots) {
+				uint64_t data = slot.data.load(std::memory_order_relaxed);
+				used += (data != 0 && Age(data, now) == 0) ? 1 : 0;
+			}
+		}
+		return double(used) / double(sample * slots_per_bucket);
+	}
+
+	size_t Capacity() const { return bucket_count * slots_per_bucket; }
+	size_t MemoryUsed() const { return bucket_count * sizeof(Bucket); }
+
+private:
+	static constexpr int slots_per_bucket = 4;
+	static constexpr int empty_worth = std::numeric_limits<int>::min();
+
+	struct Slot {
+		std::atomic<uint64_t> check{ 0 };
+		std::atomic<uint64_t> data{ 0 };
+	};
+
+	struct alignas(64) Bucket {
+		Slot slots[slots_per_bucket];
+	};
+
+	// value:32 | depth:8 | bound:8 | move:8 | generation:8.  The generation is
+	// always odd so a stored entry never packs to 0.
+	static uint64_t Pack(const Entry& e, uint8_t gen) {
+		uint32_t bits;
+		std::memcpy(&bits, &e.value, sizeof(bits));
+		return uint64_t(bits) | uint64_t(e.depth) << 32 | uint64_t(e.bound) << 40 | uint64_t(e.move) << 48 | uint64_t(gen) << 56;
+	}
+
+	static Entry Unpack(uint64_t data) {
+		Entry e;
+		uint32_t bits = uint32_t(data);
+		std::memcpy(&e.value, &bits, sizeof(bits));
+		e.depth = uint8_t(data >> 32);
+		e.bound = Bound(uint8_t(data >> 40));
+		e.move = uint8_t(data >> 48);
+		return e;
+	}
+
+	static int Age(uint64_t data, uint8_t now) {
+		return uint8_t(now - uint8_t(data >> 56)) / 2;
+	}
+
+	int Worth(int depth, int age) const {
+		switch (replacement) {
+		case Replacement::ALWAYS: return 0;
+		case Replacement::DEPTH: return depth;
+		default: return depth - 8 * age;
+		}
+	}
+
+	Replacement replacement;
+	size_t bucket_count = 0;
+	std::unique_ptr<Bucket[]> buckets;
+	std::atomic<uint8_t> generation{ 1 };
+};
@@ -0,0 +1,224 @@
+#pragma once
+
+// Positions that slide to a new spot over time, any number at once.
+//
+// Each tween moves one olc::vf2d, usually a Card::position, from where it was
+// when started to a destination, with its own duration and easing.  Tweens are
+// kept as parallel arrays.  Every easing is a cubic in the progress, kept as
+// three coefficients per tween, so Update advances and eases them all in one
+// branch free loop over float arrays that the compiler vectorises.
+//
+//	tweens.Start(&card.position, spot, 0.5f);  // from card.position to spot
+//	tweens.Start(&card.position, other, 0.5f); // retargets, from where it is now
+//	tweens.Update(fElapsedTime);               // every frame, writes positions
+//	if (!tweens.Active()) { ... }              // everything has arrived
+//
+// A tween writes through its pointer every Update, so the vf2d must stay put
+// while it moves.  Stop or Clear before erasing or reallocating what holds it.
+
+#include "olcPixelGameEngine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+enum class Easing : uint8_t {
+	LINEAR,
+	IN_OUT, // Slow at both ends, smoothstep, within 0.01 of a half cosine
+	OUT,    // Fast start, slowing into place
+};
+
+// An easing as t * (a + t * (b + t * c)), exactly 1 at t = 1
+struct EasingCubic {
+	float a, b, c;
+};
+
+constexpr EasingCubic Cubic(Easing easing) {
+	switch (easing) {
+	case Easing::IN_OUT: return { 0.0f, 3.0f, -2.0f };
+	case Easing::OUT: return { 2.0f, -1.0f, 0.0f };
+	default: return { 1.0f, 0.0f, 0.0f };
+	}
+}
+
+class TweenSet {
+public:
+	// Room for this many tweens before the arrays have to grow
+	explicit TweenSet(size_t capacity = 32) {
+		Reserve(capacity);
+	}
+
+	void Reserve(size_t capacity) {
+		targets.reserve(capacity);
+		from_x.reserve(capacity);
+		from_y.reserve(capacity);
+		to_x.reserve(capacity);
+		to_y.reserve(capacity);
+		progress.reserve(capacity);
+		rate.reserve(capacity);
+		ease_a.reserve(capacity);
+		ease_b.reserve(capacity);
+		ease_c.reserve(capacity);
+		scratch.reserve(2 * capacity);
+	}
+
+	// Moves *target from where it is now to `to` over duration seconds.  A
+	// target that is already moving is retargeted, starting again from its
+	// current position.
+	void Start(olc::vf2d* target, const olc::vf2d& to, float duration, Easing easing = Easing::IN_OUT) {
+		int i = Find(target);
+		if (i < 0) {
+			i = int(targets.size());
+			targets.push_back(target);
+			from_x.push_back(0.0f);
+			from_y.push_back(0.0f);
+			to_x.push_back(0.0f);
+			to_y.push_back(0.0f);
+			progress.push_back(0.0f);
+			rate.push_back(0.0f);
+			ease_a.push_back(0.0f);
+			ease_b.push_back(0.0f);
+			ease_c.push_back(0.0f);
+		}
+		from_x[i] = target->x;
+		from_y[i] = target->y;
+		to_x[i] = to.x;
+		to_y[i] = to.y;
+		progress[i] = 0.0f;
+		rate[i] = duration > 0.0f ? 1.0f / duration : INFINITY;
+		const EasingCubic cubic = Cubic(easing);
+		ease_a[i] = cubic.a;
+		ease_b[i] = cubic.b;
+		ease_c[i] = cubic.c;
+	}
+
+	// Leaves target where it is
+	void Stop(const olc::vf2d* target) {
+		int i = Find(target);
+		if (i >= 0) {
+			Remove(i);
+		}
+	}
+
+	// Puts target at its destination now
+	void Finish(const olc::vf2d* target) {
+		int i = Find(target);
+		if (i >= 0) {
+			*targets[i] = { to_x[i], to_y[i] };
+			Remove(i);
+		}
+	}
+
+	// Puts every target at its destination now
+	void FinishAll() {
+		for (size_t i = 0; i < targets.size(); i++) {
+			*targets[i] = { to_x[i], to_y[i] };
+		}
+		Clear();
+	}
+
+	// Leaves every target where it is.  Storage is kept, so starting as many
+	// tweens again does not allocate.
+	void Clear() {
+		targets.clear();
+		from_x.clear();
+		from_y.clear();
+		to_x.clear();
+		to_y.clear();
+		progress.clear();
+		rate.clear();
+		ease_a.clear();
+		ease_b.clear();
+		ease_c.clear();
+	}
+
+	bool Active() const {
+		return !targets.empty();
+	}
+
+	bool Moving(const olc::vf2d* target) const {
+		return Find(target) >= 0;
+	}
+
+	size_t Size() const {
+		return targets.size();
+	}
+
+	// Advances every tween by dt seconds and writes the positions.  Tweens
+	// that arrive are dropped.
+	void Update(float dt) {
+		const int count = int(targets.size());
+		scratch.resize(2 * size_t(count));
+		float* __restrict p = progress.data();
+		const float* __restrict r = rate.data();
+		const float* __restrict a = ease_a.data();
+		const float* __restrict b = ease_b.data();
+		const float* __restrict c = ease_c.data();
+		const float* __restrict fx = from_x.data();
+		const float* __restrict fy = from_y.data();
+		const float* __restrict tx = to_x.data();
+		const float* __restrict ty = to_y.data();
+		float* __restrict x = scratch.data();
+		float* __restrict y = x + count;
+		for (int i = 0; i < count; i++) {
+			float t = std::min(1.0f, p[i] + dt * r[i]);
+			float e = t * (a[i] + t * (b[i] + t * c[i]));
+			p[i] = t;
+			x[i] = fx[i] + e * (tx[i] - fx[i]);
+			y[i] = fy[i] + e * (ty[i] - fy[i]);
+		}
+		for (int i = 0; i < count; i++) {
+			*targets[i] = { x[i], y[i] };
+		}
+		for (int i = count - 1; i >= 0; i--) {
+			if (p[i] >= 1.0f) {
+				Remove(i);
+			}
+		}
+	}
+
+private:
+	std::vector<olc::vf2d*> targets;
+	std::vector<float> from_x;
+	std::vector<float> from_y;
+	std::vector<float> to_x;
+	std::vector<float> to_y;
+	std::vector<float> progress; // 0 to 1
+	std::vector<float> rate;     // progress per second
+	std::vector<float> ease_a;   // the easing, see EasingCubic
+	std::vector<float> ease_b;
+	std::vector<float> ease_c;
+	// The new positions, only used within Update
+	std::vector<float> scratch;
+
+	int Find(const olc::vf2d* target) const {
+		auto it = std::find(targets.begin(), targets.end(), target);
+		return it != targets.end() ? int(it - targets.begin()) : -1;
+	}
+
+	// Moves the last tween into slot i
+	void Remove(int i) {
+		int last = int(targets.size()) - 1;
+		targets[i] = targets[last];
+		from_x[i] = from_x[last];
+		from_y[i] = from_y[last];
+		to_x[i] = to_x[last];
+		to_y[i] = to_y[last];
+		progress[i] = progress[last];
+		rate[i] = rate[last];
+		ease_a[i] = ease_a[last];
+		ease_b[i] = ease_b[last];
+		ease_c[i] = ease_c[last];
+		targets.pop_back();
+		from_x.pop_back();
+		from_y.pop_back();
+		to_x.pop_back();
+		to_y.pop_back();
+		progress.pop_back();
+		rate.pop_back();
+		ease_a.pop_back();
+		ease_b.pop_back();
+		ease_c.pop_back();
+	}
+};
@@ -134,6 +134,7 @@ namespace olc
 		bool m_bZoomClamp = false;
 		olc::vf2d m_vMaxScale = { 0.0f, 0.0f };
 		olc::vf2d m_vMinScale = { 0.0f, 0.0f };
+		std::vector<olc::vf2d> m_vTransformed;
 
 	public: // Hopefully, these should look familiar!
 		// Plots a single point
@@ -203,6 +204,8 @@ namespace olc
 		void DrawLineDecal(const olc::vf2d& pos1, const olc::vf2d& pos2, Pixel p = olc::WHITE);
 		void DrawPolygonDecal(olc::Decal* decal, const std::vector<olc::vf2d>& pos, const std::vector<olc::vf2d>& uv, const std::vector<olc::Pixel>& tint);
 		void DrawPolygonDecal(olc::Decal* decal, const std::vector<olc::vf2d>& pos, const std::vector<olc::vf2d>& uv, const std::vector<olc::Pixel>& colours, const olc::Pixel tint);
+		// As above, transforming into a buffer kept between calls rather than a new vector
+		void DrawPolygonDecal(olc::Decal* decal, const olc::vf2d* pos, const olc::vf2d* uv, uint32_t points, const olc::Pixel tint = olc::WHITE);
 
 
 #if defined(OLC_PGEX_SHADER)
@@ -702,6 +705,14 @@ namespace olc
 		pge->DrawPolygonDecal(decal, vTransformed, uv, colours, tint);
 	}
 
+	void TransformedView::DrawPolygonDecal(olc::Decal* decal, const olc::vf2d* pos, const olc::vf2d* uv, uint32_t points, const olc::Pixel tint)
+	{
+		m_vTransformed.resize(points);
+		for (uint32_t n = 0; n < points; n++)
+			m_vTransformed[n] = WorldToScreen(pos[n]);
+		pge->DrawPolygonDecal(decal, m_vTransformed.data(), uv, points, tint);
+	}
+
 
 
 #if defined (OLC_PGEX_SHADER)
@@ -394,6 +394,7 @@ int main()
 #include <cmath>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <streambuf>
 #include <sstream>
@@ -432,6 +433,20 @@ int main()
 #define OLC_KEYBOARD_UK
 #endif
 
+// Bulk pixel operations are vectorised for the target, define
+// OLC_PIXEL_NO_SIMD to use the scalar versions everywhere
+#if defined(OLC_PIXEL_NO_SIMD)
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define OLC_PIXEL_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OLC_PIXEL_SSE2
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define OLC_PIXEL_WASM_SIMD
+#endif
+
 
 #if defined(USE_EXPERIMENTAL_FS) || defined(FORCE_EXPERIMENTAL_FS)
 	// C++14
@@ -452,6 +467,14 @@ namespace _gfs = std::filesystem;
 
 #define UNUSED(x) (void)(x)
 
+// Optional profiling hooks, define before including to instrument the core loop
+#if !defined(OLC_TRACE_SCOPE)
+#define OLC_TRACE_SCOPE(name)
+#endif
+#if !defined(OLC_TRACE_FRAME)
+#define OLC_TRACE_FRAME()
+#endif
+
 // O------------------------------------------------------------------------------O
 // | PLATFORM SELECTION CODE, Thanks slavka!                                      |
 // O------------------------------------------------------------------------------O
@@ -631,6 +654,15 @@ namespace olc
 	Pixel PixelF(float red, float green, float blue, float alpha = 1.0f);
 	Pixel PixelLerp(const olc::Pixel& p1, const olc::Pixel& p2, float t);
 
+	// Bulk versions of the above over count pixels, with the same results pixel
+	// for pixel.  dst may be one of the sources.
+	// dst[i] = src[i] * f
+	void PixelScale(olc::Pixel* dst, const olc::Pixel* src, size_t count, float f);
+	// dst[i] = PixelLerp(p1[i], p2[i], t)
+	void PixelLerp(olc::Pixel* dst, const olc::Pixel* p1, const olc::Pixel* p2, size_t count, float t);
+	// Blends src over dst as Draw does in Pixel::ALPHA mode
+	void PixelBlend(olc::Pixel* dst, const olc::Pixel* src, size_t count, float fBlendFactor = 1.0f);
+
 
 	// O------------------------------------------------------------------------------O
 	// | USEFUL CONSTANTS                                                             |
@@ -692,9 +724,9 @@ namespace olc
 	{
 		T x = 0;
 		T y = 0;
-		v2d_generic() : x(0), y(0) {}
-		v2d_generic(T _x, T _y) : x(_x), y(_y) {}
-		v2d_generic(const v2d_generic& v) : x(v.x), y(v.y) {}
+		constexpr v2d_generic() : x(0), y(0) {}
+		constexpr v2d_generic(T _x, T _y) : x(_x), y(_y) {}
+		constexpr v2d_generic(const v2d_generic& v) : x(v.x), y(v.y) {}
 		v2d_generic& operator=(const v2d_generic& v) = default;
 		T mag() const { return T(std::sqrt(x * x + y * y)); }
 		T mag2() const { return x * x + y * y; }
@@ -728,9 +760,9 @@ namespace olc
 		bool operator != (const v2d_generic& rhs) const { return (this->x != rhs.x || this->y != rhs.y); }
 		const std::string str() const { return std::string("(") + std::to_string(this->x) + "," + std::to_string(this->y) + ")"; }
 		friend std::ostream& operator << (std::ostream& os, const v2d_generic& rhs) { os << rhs.str(); return os; }
-		operator v2d_generic<int32_t>() const { return { static_cast<int32_t>(this->x), static_cast<int32_t>(this->y) }; }
-		operator v2d_generic<float>() const { return { static_cast<float>(this->x), static_cast<float>(this->y) }; }
-		operator v2d_generic<double>() const { return { static_cast<double>(this->x), static_cast<double>(this->y) }; }
+		constexpr operator v2d_generic<int32_t>() const { return { static_cast<int32_t>(this->x), static_cast<int32_t>(this->y) }; }
+		constexpr operator v2d_generic<float>() const { return { static_cast<float>(this->x), static_cast<float>(this->y) }; }
+		constexpr operator v2d_generic<double>() const { return { static_cast<double>(this->x), static_cast<double>(this->y) }; }
 	};
 
 	// Note: joshinils has some good suggestions here, but they are complicated to implement at this moment, 
@@ -776,6 +808,105 @@ namespace olc
 	typedef v2d_generic<double> vd2d;
 #endif
 
+	// O------------------------------------------------------------------------------O
+	// | olc::font - The built in 8x8 font, decoded at compile time                   |
+	// O------------------------------------------------------------------------------O
+	namespace font
+	{
+		constexpr int32_t nSheetWidth = 128;
+		constexpr int32_t nSheetHeight = 48;
+
+		// 6 bits per character, every 4 characters are 24 pixels down the columns
+		constexpr char sEncoded[] =
+			"?Q`0001oOch0o01o@F40o0<AGD4090LAGD<090@A7ch0?00O7Q`0600>00000000"
+			"O000000nOT0063Qo4d8>?7a14Gno94AA4gno94AaOT0>o3`oO400o7QN00000400"
+			"Of80001oOg<7O7moBGT7O7lABET024@aBEd714AiOdl717a_=TH013Q>00000000"
+			"720D000V?V5oB3Q_HdUoE7a9@DdDE4A9@DmoE4A;Hg]oM4Aj8S4D84@`00000000"
+			"OaPT1000Oa`^13P1@AI[?g`1@A=[OdAoHgljA4Ao?WlBA7l1710007l100000000"
+			"ObM6000oOfMV?3QoBDD`O7a0BDDH@5A0BDD<@5A0BGeVO5ao@CQR?5Po00000000"
+			"Oc``000?Ogij70PO2D]??0Ph2DUM@7i`2DTg@7lh2GUj?0TO0C1870T?00000000"
+			"70<4001o?P<7?1QoHg43O;`h@GT0@:@LB@d0>:@hN@L0@?aoN@<0O7ao0000?000"
+			"OcH0001SOglLA7mg24TnK7ln24US>0PL24U140PnOgl0>7QgOcH0K71S0000A000"
+			"00H00000@Dm1S007@DUSg00?OdTnH7YhOfTL<7Yh@Cl0700?@Ah0300700000000"
+			"<008001QL00ZA41a@6HnI<1i@FHLM81M@@0LG81?O`0nC?Y7?`0ZA7Y300080000"
+			"O`082000Oh0827mo6>Hn?Wmo?6HnMb11MP08@C11H`08@FP0@@0004@000000000"
+			"00P00001Oab00003OcKP0006@6=PMgl<@440MglH@000000`@000001P00000000"
+			"Ob@8@@00Ob@8@Ga13R@8Mga172@8?PAo3R@827QoOb@820@0O`0007`0000007P0"
+			"O`000P08Od400g`<3V=P0G`673IP0`@3>1`00P@6O`P00g`<O`000GP800000000"
+			"?P9PL020O`<`N3R0@E4HC7b0@ET<ATB0@@l6C4B0O`H3N7b0?P01L3R000000020";
+
+		// The sheet as RGBA8, ready to upload.  Set pixels are 0xFFFFFFFF and the
+		// rest 0, so byte order does not matter.
+		constexpr std::array<uint32_t, nSheetWidth * nSheetHeight> Decode()
+		{
+			std::array<uint32_t, nSheetWidth * nSheetHeight> sheet = {};
+			int32_t px = 0, py = 0;
+			for (size_t b = 0; b < 1024; b += 4)
+			{
+				uint32_t sym1 = uint32_t(sEncoded[b + 0]) - 48;
+				uint32_t sym2 = uint32_t(sEncoded[b + 1]) - 48;
+				uint32_t sym3 = uint32_t(sEncoded[b + 2]) - 48;
+				uint32_t sym4 = uint32_t(sEncoded[b + 3]) - 48;
+				uint32_t r = sym1 << 18 | sym2 << 12 | sym3 << 6 | sym4;
+
+				for (int i = 0; i < 24; i++)
+				{
+					sheet[size_t(py * nSheetWidth + px)] = (r & (1u << i)) ? 0xFFFFFFFF : 0;
+					if (++py == nSheetHeight) { px++; py = 0; }
+				}
+			}
+			return sheet;
+		}
+
+		constexpr std::array<uint32_t, nSheetWidth * nSheetHeight> vSheet = Decode();
+
+		// Per glyph from ' ', the first column drawn in the high nibble and the
+		// width in the low nibble, for proportional text
+		constexpr std::array<uint8_t, 96> vSpacing = { {
+			0x03,0x25,0x16,0x08,0x07,0x08,0x08,0x04,0x15,0x15,0x08,0x07,0x15,0x07,0x24,0x08,
+			0x08,0x17,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x24,0x15,0x06,0x07,0x16,0x17,
+			0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x17,0x08,0x08,0x17,0x08,0x08,0x08,
+			0x08,0x08,0x08,0x08,0x17,0x08,0x08,0x08,0x08,0x17,0x08,0x15,0x08,0x15,0x08,0x08,
+			0x24,0x18,0x17,0x17,0x17,0x17,0x17,0x17,0x17,0x33,0x17,0x17,0x33,0x18,0x17,0x17,
+			0x17,0x17,0x17,0x17,0x07,0x17,0x17,0x18,0x18,0x17,0x17,0x07,0x33,0x07,0x08,0x00,
+		} };
+
+		constexpr int32_t GlyphWidth(char c)
+		{
+			return (c >= 32 && c < 127) ? vSpacing[size_t(c - 32)] & 15 : 0;
+		}
+	}
+
+	// Size of text drawn with DrawString, usable at compile time for fixed labels
+	constexpr olc::vi2d TextSize(std::string_view s, int32_t nTabSize = nTabSizeInSpaces)
+	{
+		int32_t sx = 0, sy = 1, px = 0, py = 1;
+		for (char c : s)
+		{
+			if (c == '\n') { py++; px = 0; }
+			else if (c == '\t') { px += nTabSize; }
+			else px++;
+			sx = std::max(sx, px);
+			sy = std::max(sy, py);
+		}
+		return { sx * 8, sy * 8 };
+	}
+
+	// Size of text drawn with DrawStringProp
+	constexpr olc::vi2d TextSizeProp(std::string_view s, int32_t nTabSize = nTabSizeInSpaces)
+	{
+		int32_t sx = 0, sy = 1, px = 0, py = 1;
+		for (char c : s)
+		{
+			if (c == '\n') { py++; px = 0; }
+			else if (c == '\t') { px += nTabSize * 8; }
+			else px += font::GlyphWidth(c);
+			sx = std::max(sx, px);
+			sy = std::max(sy, py);
+		}
+		return { sx, sy * 8 };
+	}
+
 
 
 
@@ -946,6 +1077,8 @@ namespace olc
 		olc::Renderable pDrawTarget;
 		uint32_t nResID = 0;
 		std::vector<DecalInstance> vecDecalInstance;
+		// Spent instances are kept here so their buffers can be reused next frame
+		std::vector<DecalInstance> vecDecalPool;
 		olc::Pixel tint = olc::WHITE;
 		std::function<void()> funcHook = nullptr;
 	};
@@ -1193,6 +1326,7 @@ namespace olc
 		void GradientTriangleDecal(const olc::vf2d& p0, const olc::vf2d& p1, const olc::vf2d& p2, const olc::Pixel c0, const olc::Pixel c1, const olc::Pixel c2);
 		// Draws an arbitrary convex textured polygon using GPU
 		void DrawPolygonDecal(olc::Decal* decal, const std::vector<olc::vf2d>& pos, const std::vector<olc::vf2d>& uv, const olc::Pixel tint = olc::WHITE);
+		void DrawPolygonDecal(olc::Decal* decal, const olc::vf2d* pos, const olc::vf2d* uv, uint32_t points, const olc::Pixel tint = olc::WHITE);
 		void DrawPolygonDecal(olc::Decal* decal, const std::vector<olc::vf2d>& pos, const std::vector<float>& depth, const std::vector<olc::vf2d>& uv, const olc::Pixel tint = olc::WHITE);
 		void DrawPolygonDecal(olc::Decal* decal, const std::vector<olc::vf2d>& pos, const std::vector<olc::vf2d>& uv, const std::vector<olc::Pixel>& tint);
 		void DrawPolygonDecal(olc::Decal* decal, const std::vector<olc::vf2d>& pos, const std::vector<olc::vf2d>& uv, const std::vector<olc::Pixel>& colours, const olc::Pixel tint);
@@ -1267,6 +1401,7 @@ namespace olc
 		std::string sAppName;
 
 	private: // Inner mysterious workings
+		std::string sWindowTitle;
 		olc::Sprite* pDrawTarget = nullptr;
 		Pixel::Mode	nPixelMode = Pixel::NORMAL;
 		float		fBlendFactor = 1.0f;
@@ -1306,6 +1441,7 @@ namespace olc
 		std::function<olc::Pixel(const int x, const int y, const olc::Pixel&, const olc::Pixel&)> funcPixelMode;
 		std::chrono::time_point<std::chrono::system_clock> m_tp1, m_tp2;
 		std::vector<olc::vi2d> vFontSpacing;
+		std::vector<olc::Pixel> vSpanBuffer;
 		std::vector<std::string> vDroppedFiles;
 		std::vector<std::string> vDroppedFilesCache;
 		olc::vi2d vDroppedFilesPoint;
@@ -1358,7 +1494,14 @@ namespace olc
 		void olc_UpdateWindowSize(int32_t x, int32_t y);
 		void olc_UpdateViewport();
 		void olc_ConstructFontSheet();
+		void olc_FillSpan(int32_t x0, int32_t x1, int32_t y, Pixel p);
+		void olc_BlitSpan(int32_t x, int32_t y, const Pixel* src, int32_t n);
 		void olc_CoreUpdate();
+		DecalInstance& olc_NewDecalInstance();
+		void olc_RecycleDecalInstances(LayerDesc& layer);
+		void olc_ReserveDecalInstance(DecalInstance& di);
+		static constexpr uint32_t nDecalInstancePoints = 16;
+		static constexpr size_t nDecalPoolSize = 256;
 		void olc_PrepareEngine();
 		void olc_UpdateMouseState(int32_t button, bool state);
 		void olc_UpdateKeyState(int32_t key, bool state);
@@ -1648,6 +1791,190 @@ namespace olc
 	{
 		return (p2 * t) + p1 * (1.0f - t);
 	}
+
+	// Bulk operations work on a few pixels at a time as floats, one vector per
+	// pixel (two per vector for AVX2), converting with the same float maths and
+	// truncation as the operators above so the results match bit for bit.
+	// PixelLanes holds the load, store and arithmetic for the target.
+#if defined(OLC_PIXEL_AVX2)
+	struct PixelLanes
+	{
+		static constexpr size_t nPixels = 8;
+		using F = __m256;
+
+		static void Load(const olc::Pixel* p, F (&f)[4])
+		{
+			for (int k = 0; k < 4; k++)
+				f[k] = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p + 2 * k))));
+		}
+
+		static void Store(olc::Pixel* p, const F (&f)[4])
+		{
+			// Packing works within 128 bit halves, leaving the pixels in the order
+			// 0 2 4 6 1 3 5 7
+			__m256i lo = _mm256_packs_epi32(_mm256_cvttps_epi32(f[0]), _mm256_cvttps_epi32(f[1]));
+			__m256i hi = _mm256_packs_epi32(_mm256_cvttps_epi32(f[2]), _mm256_cvttps_epi32(f[3]));
+			__m256i v = _mm256_packus_epi16(lo, hi);
+			v = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+		}
+
+		static F Set(float f) { return _mm256_set1_ps(f); }
+		static F Add(F a, F b) { return _mm256_add_ps(a, b); }
+		static F Sub(F a, F b) { return _mm256_sub_ps(a, b); }
+		static F Mul(F a, F b) { return _mm256_mul_ps(a, b); }
+		static F Div(F a, F b) { return _mm256_div_ps(a, b); }
+		static F Clamp(F a) { return _mm256_min_ps(_mm256_set1_ps(255.0f), _mm256_max_ps(_mm256_setzero_ps(), a)); }
+		static F Trunc(F a) { return _mm256_cvtepi32_ps(_mm256_cvttps_epi32(a)); }
+		static F Alpha(F a) { return _mm256_shuffle_ps(a, a, 0xFF); }
+		static F WithAlpha(F rgb, F alpha) { return _mm256_blend_ps(rgb, alpha, 0x88); }
+	};
+#elif defined(OLC_PIXEL_SSE2)
+	struct PixelLanes
+	{
+		static constexpr size_t nPixels = 4;
+		using F = __m128;
+
+		static void Load(const olc::Pixel* p, F (&f)[4])
+		{
+			const __m128i zero = _mm_setzero_si128();
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			__m128i lo = _mm_unpacklo_epi8(v, zero);
+			__m128i hi = _mm_unpackhi_epi8(v, zero);
+			f[0] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero));
+			f[1] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero));
+			f[2] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero));
+			f[3] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero));
+		}
+
+		static void Store(olc::Pixel* p, const F (&f)[4])
+		{
+			__m128i lo = _mm_packs_epi32(_mm_cvttps_epi32(f[0]), _mm_cvttps_epi32(f[1]));
+			__m128i hi = _mm_packs_epi32(_mm_cvttps_epi32(f[2]), _mm_cvttps_epi32(f[3]));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_packus_epi16(lo, hi));
+		}
+
+		static F Set(float f) { return _mm_set1_ps(f); }
+		static F Add(F a, F b) { return _mm_add_ps(a, b); }
+		static F Sub(F a, F b) { return _mm_sub_ps(a, b); }
+		static F Mul(F a, F b) { return _mm_mul_ps(a, b); }
+		static F Div(F a, F b) { return _mm_div_ps(a, b); }
+		static F Clamp(F a) { return _mm_min_ps(_mm_set1_ps(255.0f), _mm_max_ps(_mm_setzero_ps(), a)); }
+		static F Trunc(F a) { return _mm_cvtepi32_ps(_mm_cvttps_epi32(a)); }
+		static F Alpha(F a) { return _mm_shuffle_ps(a, a, 0xFF); }
+		static F WithAlpha(F rgb, F alpha)
+		{
+			const __m128 mask = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+			return _mm_or_ps(_mm_andnot_ps(mask, rgb), _mm_and_ps(mask, alpha));
+		}
+	};
+#elif defined(OLC_PIXEL_WASM_SIMD)
+	struct PixelLanes
+	{
+		static constexpr size_t nPixels = 4;
+		using F = v128_t;
+
+		static void Load(const olc::Pixel* p, F (&f)[4])
+		{
+			v128_t v = wasm_v128_load(p);
+			v128_t lo = wasm_u16x8_extend_low_u8x16(v);
+			v128_t hi = wasm_u16x8_extend_high_u8x16(v);
+			f[0] = wasm_f32x4_convert_i32x4(wasm_u32x4_extend_low_u16x8(lo));
+			f[1] = wasm_f32x4_convert_i32x4(wasm_u32x4_extend_high_u16x8(lo));
+			f[2] = wasm_f32x4_convert_i32x4(wasm_u32x4_extend_low_u16x8(hi));
+			f[3] = wasm_f32x4_convert_i32x4(wasm_u32x4_extend_high_u16x8(hi));
+		}
+
+		static void Store(olc::Pixel* p, const F (&f)[4])
+		{
+			v128_t lo = wasm_i16x8_narrow_i32x4(wasm_i32x4_trunc_sat_f32x4(f[0]), wasm_i32x4_trunc_sat_f32x4(f[1]));
+			v128_t hi = wasm_i16x8_narrow_i32x4(wasm_i32x4_trunc_sat_f32x4(f[2]), wasm_i32x4_trunc_sat_f32x4(f[3]));
+			wasm_v128_store(p, wasm_u8x16_narrow_i16x8(lo, hi));
+		}
+
+		static F Set(float f) { return wasm_f32x4_splat(f); }
+		static F Add(F a, F b) { return wasm_f32x4_add(a, b); }
+		static F Sub(F a, F b) { return wasm_f32x4_sub(a, b); }
+		static F Mul(F a, F b) { return wasm_f32x4_mul(a, b); }
+		static F Div(F a, F b) { return wasm_f32x4_div(a, b); }
+		static F Clamp(F a) { return wasm_f32x4_pmin(wasm_f32x4_splat(255.0f), wasm_f32x4_pmax(wasm_f32x4_splat(0.0f), a)); }
+		static F Trunc(F a) { return wasm_f32x4_trunc(a); }
+		static F Alpha(F a) { return wasm_i32x4_shuffle(a, a, 3, 3, 3, 3); }
+		static F WithAlpha(F rgb, F alpha) { return wasm_i32x4_shuffle(rgb, alpha, 0, 1, 2, 7); }
+	};
+#endif
+
+	void PixelScale(olc::Pixel* dst, const olc::Pixel* src, size_t count, float f)
+	{
+		size_t i = 0;
+#if defined(OLC_PIXEL_AVX2) || defined(OLC_PIXEL_SSE2) || defined(OLC_PIXEL_WASM_SIMD)
+		using L = PixelLanes;
+		const L::F vf = L::Set(f);
+		for (; i + L::nPixels <= count; i += L::nPixels)
+		{
+			L::F s[4];
+			L::Load(src + i, s);
+			for (auto& c : s) c = L::WithAlpha(L::Clamp(L::Mul(c, vf)), c);
+			L::Store(dst + i, s);
+		}
+#endif
+		for (; i < count; i++) dst[i] = src[i] * f;
+	}
+
+	void PixelLerp(olc::Pixel* dst, const olc::Pixel* p1, const olc::Pixel* p2, size_t count, float t)
+	{
+		size_t i = 0;
+#if defined(OLC_PIXEL_AVX2) || defined(OLC_PIXEL_SSE2) || defined(OLC_PIXEL_WASM_SIMD)
+		using L = PixelLanes;
+		const L::F vt = L::Set(t), vu = L::Set(1.0f - t);
+		for (; i + L::nPixels <= count; i += L::nPixels)
+		{
+			L::F a[4], b[4];
+			L::Load(p1 + i, a);
+			L::Load(p2 + i, b);
+			// Both sides are truncated to bytes before the saturating add
+			for (int k = 0; k < 4; k++)
+			{
+				L::F sum = L::Add(L::Trunc(L::Clamp(L::Mul(b[k], vt))), L::Trunc(L::Clamp(L::Mul(a[k], vu))));
+				a[k] = L::WithAlpha(L::Clamp(sum), b[k]);
+			}
+			L::Store(dst + i, a);
+		}
+#endif
+		for (; i < count; i++) dst[i] = PixelLerp(p1[i], p2[i], t);
+	}
+
+	void PixelBlend(olc::Pixel* dst, const olc::Pixel* src, size_t count, float fBlendFactor)
+	{
+		size_t i = 0;
+#if defined(OLC_PIXEL_AVX2) || defined(OLC_PIXEL_SSE2) || defined(OLC_PIXEL_WASM_SIMD)
+		using L = PixelLanes;
+		const L::F vBlend = L::Set(fBlendFactor), v255 = L::Set(255.0f), vOne = L::Set(1.0f);
+		for (; i + L::nPixels <= count; i += L::nPixels)
+		{
+			L::F s[4], d[4];
+			L::Load(src + i, s);
+			L::Load(dst + i, d);
+			for (int k = 0; k < 4; k++)
+			{
+				L::F a = L::Mul(L::Div(L::Alpha(s[k]), v255), vBlend);
+				L::F c = L::Sub(vOne, a);
+				d[k] = L::WithAlpha(L::Add(L::Mul(a, s[k]), L::Mul(c, d[k])), v255);
+			}
+			L::Store(dst + i, d);
+		}
+#endif
+		for (; i < count; i++)
+		{
+			const olc::Pixel p = src[i], d = dst[i];
+			float a = (float)(p.a / 255.0f) * fBlendFactor;
+			float c = 1.0f - a;
+			float r = a * (float)p.r + c * (float)d.r;
+			float g = a * (float)p.g + c * (float)d.g;
+			float b = a * (float)p.b + c * (float)d.b;
+			dst[i] = Pixel((uint8_t)r, (uint8_t)g, (uint8_t)b/*, (uint8_t)(p.a * fBlendFactor)*/);
+		}
+	}
 #endif
 	// O------------------------------------------------------------------------------O
 	// | olc::Sprite IMPLEMENTATION                                                   |
@@ -2196,6 +2523,12 @@ namespace olc
 	{
 		LayerDesc ld;
 		ld.pDrawTarget.Create(vScreenSize.x, vScreenSize.y);
+		// Decal instances are recycled, filling the pool now keeps the first
+		// frames to draw more than ever before from allocating them
+		ld.vecDecalInstance.reserve(nDecalPoolSize);
+		ld.vecDecalPool.resize(nDecalPoolSize);
+		for (auto& di : ld.vecDecalPool)
+			olc_ReserveDecalInstance(di);
 		vLayers.push_back(std::move(ld));
 		return uint32_t(vLayers.size()) - 1;
 	}
@@ -2330,12 +2663,8 @@ namespace olc
 		if (nPixelMode == Pixel::ALPHA)
 		{
 			Pixel d = pDrawTarget->GetPixel(x, y);
-			float a = (float)(p.a / 255.0f) * fBlendFactor;
-			float c = 1.0f - a;
-			float r = a * (float)p.r + c * (float)d.r;
-			float g = a * (float)p.g + c * (float)d.g;
-			float b = a * (float)p.b + c * (float)d.b;
-			return pDrawTarget->SetPixel(x, y, Pixel((uint8_t)r, (uint8_t)g, (uint8_t)b/*, (uint8_t)(p.a * fBlendFactor)*/));
+			PixelBlend(&d, &p, 1, fBlendFactor);
+			return pDrawTarget->SetPixel(x, y, d);
 		}
 
 		if (nPixelMode == Pixel::CUSTOM)
@@ -2496,8 +2825,7 @@ namespace olc
 
 			auto drawline = [&](int sx, int ex, int y)
 				{
-					for (int x = sx; x <= ex; x++)
-						Draw(x, y, p);
+					olc_FillSpan(sx, ex + 1, y, p);
 				};
 
 			while (y0 >= x0)
@@ -2539,7 +2867,7 @@ namespace olc
 	{
 		int pixels = GetDrawTargetWidth() * GetDrawTargetHeight();
 		Pixel* m = GetDrawTarget()->GetData();
-		for (int i = 0; i < pixels; i++) m[i] = p;
+		std::fill(m, m + pixels, p);
 	}
 
 	void PixelGameEngine::ClearBuffer(Pixel p, bool bDepth)
@@ -2611,9 +2939,8 @@ namespace olc
 		if (y2 < 0) y2 = 0;
 		if (y2 >= (int32_t)GetDrawTargetHeight()) y2 = (int32_t)GetDrawTargetHeight();
 
-		for (int i = x; i < x2; i++)
-			for (int j = y; j < y2; j++)
-				Draw(i, j, p);
+		for (int j = y; j < y2; j++)
+			olc_FillSpan(x, x2, j, p);
 	}
 
 	void PixelGameEngine::DrawTriangle(const olc::vi2d& pos1, const olc::vi2d& pos2, const olc::vi2d& pos3, Pixel p)
@@ -2636,7 +2963,7 @@ namespace olc
 	// https://www.avrfreaks.net/sites/default/files/triangles.c
 	void PixelGameEngine::FillTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, Pixel p)
 	{
-		auto drawline = [&](int sx, int ex, int ny) { for (int i = sx; i <= ex; i++) Draw(i, ny, p); };
+		auto drawline = [&](int sx, int ex, int ny) { olc_FillSpan(sx, ex + 1, ny, p); };
 
 		int t1x, t2x, y, minx, maxx, t1xp, t2xp;
 		bool changed1 = false;
@@ -2941,33 +3268,7 @@ namespace olc
 		if (sprite == nullptr)
 			return;
 
-		int32_t fxs = 0, fxm = 1, fx = 0;
-		int32_t fys = 0, fym = 1, fy = 0;
-		if (flip & olc::Sprite::Flip::HORIZ) { fxs = sprite->width - 1; fxm = -1; }
-		if (flip & olc::Sprite::Flip::VERT) { fys = sprite->height - 1; fym = -1; }
-
-		if (scale > 1)
-		{
-			fx = fxs;
-			for (int32_t i = 0; i < sprite->width; i++, fx += fxm)
-			{
-				fy = fys;
-				for (int32_t j = 0; j < sprite->height; j++, fy += fym)
-					for (uint32_t is = 0; is < scale; is++)
-						for (uint32_t js = 0; js < scale; js++)
-							Draw(x + (i * scale) + is, y + (j * scale) + js, sprite->GetPixel(fx, fy));
-			}
-		}
-		else
-		{
-			fx = fxs;
-			for (int32_t i = 0; i < sprite->width; i++, fx += fxm)
-			{
-				fy = fys;
-				for (int32_t j = 0; j < sprite->height; j++, fy += fym)
-					Draw(x + i, y + j, sprite->GetPixel(fx, fy));
-			}
-		}
+		DrawPartialSprite(x, y, sprite, 0, 0, sprite->width, sprite->height, scale, flip);
 	}
 
 	void PixelGameEngine::DrawPartialSprite(const olc::vi2d& pos, Sprite* sprite, const olc::vi2d& sourcepos, const olc::vi2d& size, uint32_t scale, uint8_t flip)
@@ -2977,35 +3278,105 @@ namespace olc
 
 	void PixelGameEngine::DrawPartialSprite(int32_t x, int32_t y, Sprite* sprite, int32_t ox, int32_t oy, int32_t w, int32_t h, uint32_t scale, uint8_t flip)
 	{
-		if (sprite == nullptr)
+		if (sprite == nullptr || pDrawTarget == nullptr)
 			return;
 
-		int32_t fxs = 0, fxm = 1, fx = 0;
-		int32_t fys = 0, fym = 1, fy = 0;
-		if (flip & olc::Sprite::Flip::HORIZ) { fxs = w - 1; fxm = -1; }
-		if (flip & olc::Sprite::Flip::VERT) { fys = h - 1; fym = -1; }
+		const int32_t nScale = int32_t(std::max(scale, 1u));
+		int32_t x0 = std::max(x, 0), x1 = std::min(x + w * nScale, pDrawTarget->width);
+		int32_t y0 = std::max(y, 0), y1 = std::min(y + h * nScale, pDrawTarget->height);
+		if (x0 >= x1 || y0 >= y1)
+			return;
 
-		if (scale > 1)
+		// Rows are read straight from the sprite when they can be, otherwise
+		// scaled, flipped or wrapped into the span buffer once per source row
+		const bool bInPlace = nScale == 1 && !(flip & olc::Sprite::Flip::HORIZ) && ox >= 0 && ox + w <= sprite->width;
+		int32_t nBuffered = -1;
+		for (int32_t j = y0; j < y1; j++)
 		{
-			fx = fxs;
-			for (int32_t i = 0; i < w; i++, fx += fxm)
+			int32_t fy = (j - y) / nScale;
+			if (flip & olc::Sprite::Flip::VERT) fy = h - 1 - fy;
+			const int32_t sy = oy + fy;
+
+			if (bInPlace && sy >= 0 && sy < sprite->height)
 			{
-				fy = fys;
-				for (int32_t j = 0; j < h; j++, fy += fym)
-					for (uint32_t is = 0; is < scale; is++)
-						for (uint32_t js = 0; js < scale; js++)
-							Draw(x + (i * scale) + is, y + (j * scale) + js, sprite->GetPixel(fx + ox, fy + oy));
+				olc_BlitSpan(x0, j, sprite->GetData() + sy * sprite->width + ox + (x0 - x), x1 - x0);
+				continue;
 			}
-		}
-		else
-		{
-			fx = fxs;
-			for (int32_t i = 0; i < w; i++, fx += fxm)
+
+			if (sy != nBuffered)
 			{
-				fy = fys;
-				for (int32_t j = 0; j < h; j++, fy += fym)
-					Draw(x + i, y + j, sprite->GetPixel(fx + ox, fy + oy));
+				vSpanBuffer.resize(size_t(x1 - x0));
+				for (int32_t i = x0; i < x1; i++)
+				{
+					int32_t fx = (i - x) / nScale;
+					if (flip & olc::Sprite::Flip::HORIZ) fx = w - 1 - fx;
+					vSpanBuffer[i - x0] = sprite->GetPixel(ox + fx, sy);
+				}
+				nBuffered = sy;
 			}
+			olc_BlitSpan(x0, j, vSpanBuffer.data(), x1 - x0);
+		}
+	}
+
+	// Span primitives plot a run of pixels on one row.  The run is clipped once
+	// and the pixel mode picked once, rather than per pixel as Draw does.
+	void PixelGameEngine::olc_FillSpan(int32_t x0, int32_t x1, int32_t y, Pixel p)
+	{
+		if (pDrawTarget == nullptr || y < 0 || y >= pDrawTarget->height)
+			return;
+		x0 = std::max(x0, 0);
+		x1 = std::min(x1, pDrawTarget->width);
+		if (x0 >= x1)
+			return;
+
+		Pixel* dst = pDrawTarget->GetData() + y * pDrawTarget->width;
+		switch (nPixelMode)
+		{
+		case Pixel::NORMAL:
+			std::fill(dst + x0, dst + x1, p);
+			break;
+		case Pixel::MASK:
+			if (p.a == 255) std::fill(dst + x0, dst + x1, p);
+			break;
+		case Pixel::ALPHA:
+		{
+			// Blended from a short run of the colour, a chunk at a time
+			std::array<Pixel, 64> run;
+			run.fill(p);
+			for (int32_t x = x0; x < x1; x += int32_t(run.size()))
+				PixelBlend(dst + x, run.data(), size_t(std::min(x1 - x, int32_t(run.size()))), fBlendFactor);
+			break;
+		}
+		case Pixel::CUSTOM:
+			for (int32_t x = x0; x < x1; x++) dst[x] = funcPixelMode(x, y, p, dst[x]);
+			break;
+		}
+	}
+
+	void PixelGameEngine::olc_BlitSpan(int32_t x, int32_t y, const Pixel* src, int32_t n)
+	{
+		if (pDrawTarget == nullptr || y < 0 || y >= pDrawTarget->height)
+			return;
+		if (x < 0) { src -= x; n += x; x = 0; }
+		n = std::min(n, pDrawTarget->width - x);
+		if (n <= 0)
+			return;
+
+		Pixel* dst = pDrawTarget->GetData() + y * pDrawTarget->width + x;
+		switch (nPixelMode)
+		{
+		case Pixel::NORMAL:
+			std::copy(src, src + n, dst);
+			break;
+		case Pixel::MASK:
+			for (int32_t i = 0; i < n; i++) if (src[i].a == 255) dst[i] = src[i];
+			break;
+		case Pixel::ALPHA:
+			PixelBlend(dst, src, size_t(n), fBlendFactor);
+			break;
+		case Pixel::CUSTOM:
+			for (int32_t i = 0; i < n; i++) dst[i] = funcPixelMode(x + i, y, src[i], dst[i]);
+			break;
 		}
 	}
 
@@ -3038,7 +3409,7 @@ namespace olc
 		olc::vf2d vQuantisedPos = ((vScreenSpacePos * vWindow) + olc::vf2d(0.5f, 0.5f)).floor() / vWindow;
 		olc::vf2d vQuantisedDim = ((vScreenSpaceDim * vWindow) + olc::vf2d(0.5f, -0.5f)).ceil() / vWindow;
 
-		DecalInstance di;
+		DecalInstance& di = olc_NewDecalInstance();
 		di.points = 4;
 		di.decal = decal;
 		di.tint = { tint, tint, tint, tint };
@@ -3049,7 +3420,6 @@ namespace olc
 		di.w = { 1,1,1,1 };
 		di.mode = nDecalMode;
 		di.structure = nDecalStructure;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
 	}
 
 	void PixelGameEngine::DrawPartialDecal(const olc::vf2d& pos, const olc::vf2d& size, olc::Decal* decal, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::Pixel& tint)
@@ -3066,7 +3436,7 @@ namespace olc
 			vScreenSpacePos.y - (2.0f * size.y * vInvScreenSize.y)
 		};
 
-		DecalInstance di;
+		DecalInstance& di = olc_NewDecalInstance();
 		di.points = 4;
 		di.decal = decal;
 		di.tint = { tint, tint, tint, tint };
@@ -3077,7 +3447,6 @@ namespace olc
 		di.w = { 1,1,1,1 };
 		di.mode = nDecalMode;
 		di.structure = nDecalStructure;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
 	}
 
 
@@ -3095,7 +3464,7 @@ namespace olc
 			vScreenSpacePos.y - (2.0f * (float(decal->sprite->height) * vInvScreenSize.y)) * scale.y
 		};
 
-		DecalInstance di;
+		DecalInstance& di = olc_NewDecalInstance();
 		di.decal = decal;
 		di.points = 4;
 		di.tint = { tint, tint, tint, tint };
@@ -3104,12 +3473,11 @@ namespace olc
 		di.w = { 1, 1, 1, 1 };
 		di.mode = nDecalMode;
 		di.structure = nDecalStructure;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
 	}
 
 	void PixelGameEngine::DrawExplicitDecal(olc::Decal* decal, const olc::vf2d* pos, const olc::vf2d* uv, const olc::Pixel* col, uint32_t elements)
 	{
-		DecalInstance di;
+		DecalInstance& di = olc_NewDecalInstance();
 		di.decal = decal;
 		di.pos.resize(elements);
 		di.uv.resize(elements);
@@ -3125,14 +3493,18 @@ namespace olc
 		}
 		di.mode = nDecalMode;
 		di.structure = nDecalStructure;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
 	}
 
 	void PixelGameEngine::DrawPolygonDecal(olc::Decal* decal, const std::vector<olc::vf2d>& pos, const std::vector<olc::vf2d>& uv, const olc::Pixel tint)
 	{
-		DecalInstance di;
+		DrawPolygonDecal(decal, pos.data(), uv.data(), uint32_t(pos.size()), tint);
+	}
+
+	void PixelGameEngine::DrawPolygonDecal(olc::Decal* decal, const olc::vf2d* pos, const olc::vf2d* uv, uint32_t points, const olc::Pixel tint)
+	{
+		DecalInstance& di = olc_NewDecalInstance();
 		di.decal = decal;
-		di.points = uint32_t(pos.size());
+		di.points = points;
 		di.pos.resize(di.points);
 		di.uv.resize(di.points);
 		di.w.resize(di.points);
@@ -3146,12 +3518,11 @@ namespace olc
 		}
 		di.mode = nDecalMode;
 		di.structure = nDecalStructure;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
 	}
 
 	void PixelGameEngine::DrawPolygonDecal(olc::Decal* decal, const std::vector<olc::vf2d>& pos, const std::vector<olc::vf2d>& uv, const std::vector<olc::Pixel>& tint)
 	{
-		DecalInstance di;
+		DecalInstance& di = olc_NewDecalInstance();
 		di.decal = decal;
 		di.points = uint32_t(pos.size());
 		di.pos.resize(di.points);
@@ -3167,7 +3538,6 @@ namespace olc
 		}
 		di.mode = nDecalMode;
 		di.structure = nDecalStructure;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
 	}
 
 	void PixelGameEngine::DrawPolygonDecal(olc::Decal* decal, const std::vector<olc::vf2d>& pos, const std::vector<olc::vf2d>& uv, const std::vector<olc::Pixel>& colours, const olc::Pixel tint)
@@ -3181,7 +3551,7 @@ namespace olc
 
 	void PixelGameEngine::DrawPolygonDecal(olc::Decal* decal, const std::vector<olc::vf2d>& pos, const std::vector<float>& depth, const std::vector<olc::vf2d>& uv, const olc::Pixel tint)
 	{
-		DecalInstance di;
+		DecalInstance& di = olc_NewDecalInstance();
 		di.decal = decal;
 		di.points = uint32_t(pos.size());
 		di.pos.resize(di.points);
@@ -3197,12 +3567,11 @@ namespace olc
 		}
 		di.mode = nDecalMode;
 		di.structure = nDecalStructure;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
 	}
 
 	void PixelGameEngine::DrawPolygonDecal(olc::Decal* decal, const std::vector<olc::vf2d>& pos, const std::vector<float>& depth, const std::vector<olc::vf2d>& uv, const std::vector<olc::Pixel>& colours, const olc::Pixel tint)
 	{
-		DecalInstance di;
+		DecalInstance& di = olc_NewDecalInstance();
 		di.decal = decal;
 		di.points = uint32_t(pos.size());
 		di.pos.resize(di.points);
@@ -3218,7 +3587,6 @@ namespace olc
 		}
 		di.mode = nDecalMode;
 		di.structure = nDecalStructure;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
 	}
 
 #ifdef OLC_ENABLE_EXPERIMENTAL
@@ -3366,7 +3734,7 @@ namespace olc
 
 	void PixelGameEngine::DrawRotatedDecal(const olc::vf2d& pos, olc::Decal* decal, const float fAngle, const olc::vf2d& center, const olc::vf2d& scale, const olc::Pixel& tint)
 	{
-		DecalInstance di;
+		DecalInstance& di = olc_NewDecalInstance();
 		di.decal = decal;
 		di.pos.resize(4);
 		di.uv = { { 0.0f, 0.0f}, {0.0f, 1.0f}, {1.0f, 1.0f}, {1.0f, 0.0f} };
@@ -3387,13 +3755,12 @@ namespace olc
 		}
 		di.mode = nDecalMode;
 		di.structure = nDecalStructure;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
 	}
 
 
 	void PixelGameEngine::DrawPartialRotatedDecal(const olc::vf2d& pos, olc::Decal* decal, const float fAngle, const olc::vf2d& center, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::vf2d& scale, const olc::Pixel& tint)
 	{
-		DecalInstance di;
+		DecalInstance& di = olc_NewDecalInstance();
 		di.decal = decal;
 		di.points = 4;
 		di.tint = { tint, tint, tint, tint };
@@ -3416,7 +3783,6 @@ namespace olc
 		di.uv = { { uvtl.x, uvtl.y }, { uvtl.x, uvbr.y }, { uvbr.x, uvbr.y }, { uvbr.x, uvtl.y } };
 		di.mode = nDecalMode;
 		di.structure = nDecalStructure;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
 	}
 
 	void PixelGameEngine::DrawPartialWarpedDecal(olc::Decal* decal, const olc::vf2d* pos, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::Pixel& tint)
@@ -3599,17 +3965,7 @@ namespace olc
 
 	olc::vi2d PixelGameEngine::GetTextSize(const std::string& s)
 	{
-		olc::vi2d size = { 0,1 };
-		olc::vi2d pos = { 0,1 };
-		for (auto c : s)
-		{
-			if (c == '\n') { pos.y++;  pos.x = 0; }
-			else if (c == '\t') { pos.x += nTabSizeInSpaces; }
-			else pos.x++;
-			size.x = std::max(size.x, pos.x);
-			size.y = std::max(size.y, pos.y);
-		}
-		return size * 8;
+		return olc::TextSize(s);
 	}
 
 	void PixelGameEngine::DrawString(const olc::vi2d& pos, const std::string& sText, Pixel col, uint32_t scale)
@@ -3667,19 +4023,7 @@ namespace olc
 
 	olc::vi2d PixelGameEngine::GetTextSizeProp(const std::string& s)
 	{
-		olc::vi2d size = { 0,1 };
-		olc::vi2d pos = { 0,1 };
-		for (auto c : s)
-		{
-			if (c == '\n') { pos.y += 1;  pos.x = 0; }
-			else if (c == '\t') { pos.x += nTabSizeInSpaces * 8; }
-			else pos.x += vFontSpacing[c - 32].y;
-			size.x = std::max(size.x, pos.x);
-			size.y = std::max(size.y, pos.y);
-		}
-
-		size.y *= 8;
-		return size;
+		return olc::TextSizeProp(s);
 	}
 
 	void PixelGameEngine::DrawStringProp(const olc::vi2d& pos, const std::string& sText, Pixel col, uint32_t scale)
@@ -4270,13 +4614,57 @@ namespace olc
 		auto& layer = vLayers[nLayerID];
 		for (auto& decal : layer.vecDecalInstance)
 			renderer->DrawDecal(decal);
-		layer.vecDecalInstance.clear();
+		olc_RecycleDecalInstances(layer);
+	}
+
+
+
+	DecalInstance& PixelGameEngine::olc_NewDecalInstance()
+	{
+		auto& layer = vLayers[nTargetLayer];
+		if (layer.vecDecalPool.empty())
+		{
+			olc_ReserveDecalInstance(layer.vecDecalInstance.emplace_back());
+		}
+		else
+		{
+			layer.vecDecalInstance.push_back(std::move(layer.vecDecalPool.back()));
+			layer.vecDecalPool.pop_back();
+		}
+
+		// Recycled instances keep their buffers, reset everything else
+		DecalInstance& di = layer.vecDecalInstance.back();
+		di.decal = nullptr;
+		di.z.clear();
+		di.mode = olc::DecalMode::NORMAL;
+		di.structure = olc::DecalStructure::FAN;
+		di.points = 0;
+		di.depth = false;
+		return di;
 	}
 
+	// Room for a quad or a small polygon, so recycled instances do not grow
+	// when a frame hands them a different shape
+	void PixelGameEngine::olc_ReserveDecalInstance(DecalInstance& di)
+	{
+		di.pos.reserve(nDecalInstancePoints);
+		di.uv.reserve(nDecalInstancePoints);
+		di.w.reserve(nDecalInstancePoints);
+		di.tint.reserve(nDecalInstancePoints);
+	}
 
+	void PixelGameEngine::olc_RecycleDecalInstances(LayerDesc& layer)
+	{
+		for (auto& decal : layer.vecDecalInstance)
+			layer.vecDecalPool.push_back(std::move(decal));
+		layer.vecDecalInstance.clear();
+	}
 
 	void PixelGameEngine::olc_CoreUpdate()
 	{
+		OLC_TRACE_FRAME();
+		OLC_TRACE_SCOPE("olc_CoreUpdate");
+
 		// Handle Timing
 		m_tp2 = std::chrono::system_clock::now();
 		std::chrono::duration<float> elapsedTime = m_tp2 - m_tp1;
@@ -4290,7 +4678,10 @@ namespace olc
 			fElapsedTime = 0.0f;
 
 		// Some platforms will need to check for events
-		platform->HandleSystemEvent();
+		{
+			OLC_TRACE_SCOPE("HandleSystemEvent");
+			platform->HandleSystemEvent();
+		}
 
 		// Compare hardware input states from previous frame
 		auto ScanHardware = [&](HWButton* pKeys, bool* pStateOld, bool* pStateNew, uint32_t nKeyCount)
@@ -4316,8 +4707,11 @@ namespace olc
 				}
 			};
 
-		ScanHardware(pKeyboardState, pKeyOldState, pKeyNewState, 256);
-		ScanHardware(pMouseState, pMouseOldState, pMouseNewState, nMouseButtons);
+		{
+			OLC_TRACE_SCOPE("ScanHardware");
+			ScanHardware(pKeyboardState, pKeyOldState, pKeyNewState, 256);
+			ScanHardware(pMouseState, pMouseOldState, pMouseNewState, nMouseButtons);
+		}
 
 		// Cache mouse coordinates so they remain consistent during frame
 		vMousePos = vMousePosCache;
@@ -4334,14 +4728,17 @@ namespace olc
 		}
 
 		// Handle Frame Update
-		bool bExtensionBlockFrame = false;
-		for (auto& ext : vExtensions) bExtensionBlockFrame |= ext->OnBeforeUserUpdate(fElapsedTime);
-		if (!bExtensionBlockFrame)
 		{
-			if (!OnUserUpdate(fElapsedTime)) bAtomActive = false;
+			OLC_TRACE_SCOPE("OnUserUpdate");
+			bool bExtensionBlockFrame = false;
+			for (auto& ext : vExtensions) bExtensionBlockFrame |= ext->OnBeforeUserUpdate(fElapsedTime);
+			if (!bExtensionBlockFrame)
+			{
+				if (!OnUserUpdate(fElapsedTime)) bAtomActive = false;
 
+			}
+			for (auto& ext : vExtensions) ext->OnAfterUserUpdate(fElapsedTime);
 		}
-		for (auto& ext : vExtensions) ext->OnAfterUserUpdate(fElapsedTime);
 
 
 
@@ -4354,6 +4751,7 @@ namespace olc
 
 		if (!bManualRenderEnable)
 		{
+			OLC_TRACE_SCOPE("RenderLayers");
 			if (bConsoleShow)
 			{
 				SetDrawTarget((uint8_t)0);
@@ -4388,7 +4786,7 @@ namespace olc
 						// Display Decals in order for this layer
 						for (auto& decal : layer->vecDecalInstance)
 							renderer->DrawDecal(decal);
-						layer->vecDecalInstance.clear();
+						olc_RecycleDecalInstances(*layer);
 					}
 					else
 					{
@@ -4400,7 +4798,10 @@ namespace olc
 		}
 
 		// Present Graphics to screen
-		renderer->DisplayFrame();
+		{
+			OLC_TRACE_SCOPE("DisplayFrame");
+			renderer->DisplayFrame();
+		}
 
 		if (bResizeRequested)
 		{
@@ -4416,62 +4817,20 @@ namespace olc
 		{
 			nLastFPS = nFrameCount;
 			fFrameTimer -= 1.0f;
-			std::string sTitle = "OneLoneCoder.com - Pixel Game Engine - " + sAppName + " - FPS: " + std::to_string(nFrameCount);
-			platform->SetWindowTitle(sTitle);
+			sWindowTitle.assign("OneLoneCoder.com - Pixel Game Engine - ").append(sAppName).append(" - FPS: ").append(std::to_string(nFrameCount));
+			platform->SetWindowTitle(sWindowTitle);
 			nFrameCount = 0;
 		}
 	}
 
 	void PixelGameEngine::olc_ConstructFontSheet()
 	{
-		std::string data;
-		data += "?Q`0001oOch0o01o@F40o0<AGD4090LAGD<090@A7ch0?00O7Q`0600>00000000";
-		data += "O000000nOT0063Qo4d8>?7a14Gno94AA4gno94AaOT0>o3`oO400o7QN00000400";
-		data += "Of80001oOg<7O7moBGT7O7lABET024@aBEd714AiOdl717a_=TH013Q>00000000";
-		data += "720D000V?V5oB3Q_HdUoE7a9@DdDE4A9@DmoE4A;Hg]oM4Aj8S4D84@`00000000";
-		data += "OaPT1000Oa`^13P1@AI[?g`1@A=[OdAoHgljA4Ao?WlBA7l1710007l100000000";
-		data += "ObM6000oOfMV?3QoBDD`O7a0BDDH@5A0BDD<@5A0BGeVO5ao@CQR?5Po00000000";
-		data += "Oc``000?Ogij70PO2D]??0Ph2DUM@7i`2DTg@7lh2GUj?0TO0C1870T?00000000";
-		data += "70<4001o?P<7?1QoHg43O;`h@GT0@:@LB@d0>:@hN@L0@?aoN@<0O7ao0000?000";
-		data += "OcH0001SOglLA7mg24TnK7ln24US>0PL24U140PnOgl0>7QgOcH0K71S0000A000";
-		data += "00H00000@Dm1S007@DUSg00?OdTnH7YhOfTL<7Yh@Cl0700?@Ah0300700000000";
-		data += "<008001QL00ZA41a@6HnI<1i@FHLM81M@@0LG81?O`0nC?Y7?`0ZA7Y300080000";
-		data += "O`082000Oh0827mo6>Hn?Wmo?6HnMb11MP08@C11H`08@FP0@@0004@000000000";
-		data += "00P00001Oab00003OcKP0006@6=PMgl<@440MglH@000000`@000001P00000000";
-		data += "Ob@8@@00Ob@8@Ga13R@8Mga172@8?PAo3R@827QoOb@820@0O`0007`0000007P0";
-		data += "O`000P08Od400g`<3V=P0G`673IP0`@3>1`00P@6O`P00g`<O`000GP800000000";
-		data += "?P9PL020O`<`N3R0@E4HC7b0@ET<ATB0@@l6C4B0O`H3N7b0?P01L3R000000020";
-
-		fontRenderable.Create(128, 48);
-
-		int px = 0, py = 0;
-		for (size_t b = 0; b < 1024; b += 4)
-		{
-			uint32_t sym1 = (uint32_t)data[b + 0] - 48;
-			uint32_t sym2 = (uint32_t)data[b + 1] - 48;
-			uint32_t sym3 = (uint32_t)data[b + 2] - 48;
-			uint32_t sym4 = (uint32_t)data[b + 3] - 48;
-			uint32_t r = sym1 << 18 | sym2 << 12 | sym3 << 6 | sym4;
-
-			for (int i = 0; i < 24; i++)
-			{
-				int k = r & (1 << i) ? 255 : 0;
-				fontRenderable.Sprite()->SetPixel(px, py, olc::Pixel(k, k, k, k));
-				if (++py == 48) { px++; py = 0; }
-			}
-		}
-
+		// Decoded at compile time, see olc::font
+		fontRenderable.Create(font::nSheetWidth, font::nSheetHeight);
+		std::copy(font::vSheet.begin(), font::vSheet.end(), fontRenderable.Sprite()->GetData());
 		fontRenderable.Decal()->Update();
 
-		constexpr std::array<uint8_t, 96> vSpacing = { {
-			0x03,0x25,0x16,0x08,0x07,0x08,0x08,0x04,0x15,0x15,0x08,0x07,0x15,0x07,0x24,0x08,
-			0x08,0x17,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x24,0x15,0x06,0x07,0x16,0x17,
-			0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x17,0x08,0x08,0x17,0x08,0x08,0x08,
-			0x08,0x08,0x08,0x08,0x17,0x08,0x08,0x08,0x08,0x17,0x08,0x15,0x08,0x15,0x08,0x08,
-			0x24,0x18,0x17,0x17,0x17,0x17,0x17,0x17,0x17,0x33,0x17,0x17,0x33,0x18,0x17,0x17,
-			0x17,0x17,0x17,0x17,0x07,0x17,0x17,0x18,0x18,0x17,0x17,0x07,0x33,0x07,0x08,0x00, } };
-
-		for (auto c : vSpacing) vFontSpacing.push_back({ c >> 4, c & 15 });
+		for (auto c : font::vSpacing) vFontSpacing.push_back({ c >> 4, c & 15 });
 
 		// UK Standard Layout
 #ifdef OLC_KEYBOARD_UK